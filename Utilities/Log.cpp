@@ -10,6 +10,8 @@
 #include <unordered_map>
 #include <thread>
 #include <chrono>
+#include <memory>
+#include <vector>
 
 using namespace std::literals::chrono_literals;
 
@@ -28,9 +30,17 @@ static std::string empty_string()
 	return {};
 }
 
+static logs::raw_prefix empty_prefix()
+{
+	return logs::make_prefix("");
+}
+
 // Thread-specific log prefix provider
 thread_local std::string(*g_tls_log_prefix)() = &empty_string;
 
+// Thread-specific unformatted log prefix provider (for deferred messages, must match g_tls_log_prefix)
+thread_local logs::raw_prefix(*g_tls_log_raw_prefix)() = &empty_prefix;
+
 template<>
 void fmt_class_string<logs::level>::format(std::string& out, u64 arg)
 {
@@ -212,6 +222,410 @@ namespace logs
 			g_init = true;
 		}
 	}
+
+	// Deferred message header, followed by arguments and copied data
+	struct alignas(16) deferred_record
+	{
+		u32 size; // Record size (0: skip to the beginning of the buffer)
+		u32 argc;
+		u64 stamp;
+		message msg;
+		const char* fmt;
+		const fmt_type_info* sup;
+		const u32* copy;
+		raw_prefix prefix; // Copied arguments are replaced with data offsets
+	};
+
+	// Single producer (owner thread), single consumer (log writer)
+	struct deferred_buffer
+	{
+		static constexpr u64 size = 1 << 20;
+
+		atomic_t<u64> head{0};
+		atomic_t<u64> tail{0};
+		atomic_t<bool> busy{false}; // Producer is writing a record
+
+		std::unique_ptr<uchar[]> data{new uchar[size]};
+	};
+
+	static atomic_t<bool> s_deferred{false};
+	static atomic_t<bool> s_deferred_exit{false};
+	static atomic_t<bool> s_deferred_idle{false}; // Writer is going to wait for notification
+	static semaphore<> s_deferred_mutex;
+	static std::vector<std::shared_ptr<deferred_buffer>> s_deferred_buffers;
+	static std::shared_ptr<thread_ctrl> s_deferred_writer;
+	static thread_local std::shared_ptr<deferred_buffer> s_deferred_buffer;
+
+	static deferred_buffer& get_deferred_buffer()
+	{
+		if (!s_deferred_buffer)
+		{
+			s_deferred_buffer = std::make_shared<deferred_buffer>();
+
+			semaphore_lock lock(s_deferred_mutex);
+			s_deferred_buffers.emplace_back(s_deferred_buffer);
+		}
+
+		return *s_deferred_buffer;
+	}
+
+	// Copy strings and objects to the data, replace arguments with data offsets (returns false if some object can't be copied)
+	static bool copy_deferred_args(const u32* copy, const fmt_type_info* sup, const u64* args, u64* argv, u32 argc, std::string& data)
+	{
+		for (u32 i = 0; i < argc; i++)
+		{
+			argv[i] = args[i];
+
+			switch (const u32 type = copy[i])
+			{
+			case arg_raw:
+			{
+				break;
+			}
+			case arg_cstr:
+			{
+				argv[i] = data.size();
+				data += reinterpret_cast<const char*>(static_cast<std::uintptr_t>(args[i]));
+				data += '\0';
+				break;
+			}
+			case arg_string:
+			{
+				argv[i] = data.size();
+				data += *reinterpret_cast<const std::string*>(static_cast<std::uintptr_t>(args[i]));
+				data += '\0';
+				break;
+			}
+			case arg_opaque:
+			{
+				return false;
+			}
+			case arg_text:
+			{
+				argv[i] = data.size();
+				sup[i].fmt_string(data, args[i]);
+				data += '\0';
+				break;
+			}
+			default:
+			{
+				// Trivially copyable object
+				data.resize(::align(data.size(), 16));
+				argv[i] = data.size();
+				data.append(reinterpret_cast<const char*>(static_cast<std::uintptr_t>(args[i])), type);
+				break;
+			}
+			}
+		}
+
+		return true;
+	}
+
+	// Copy message to the current thread's buffer (returns false if the message must be sent immediately)
+	static bool push_deferred(const message& msg, u64 stamp, const char* fmt, const fmt_type_info* sup, const u64* args, const u32* copy)
+	{
+		thread_local std::vector<u64> argv;
+		thread_local std::string data;
+
+		u32 argc = 0;
+
+		while (sup[argc].fmt_string)
+		{
+			argc++;
+		}
+
+		raw_prefix prefix = g_tls_log_raw_prefix();
+
+		u32 prefix_argc = 0;
+
+		while (prefix.sup[prefix_argc].fmt_string)
+		{
+			prefix_argc++;
+		}
+
+		// Only raw values and strings are copied, formatting is done by the writer
+		argv.resize(argc);
+		data.clear();
+
+		if (!copy_deferred_args(prefix.copy, prefix.sup, prefix.args, prefix.args, prefix_argc, data) || !copy_deferred_args(copy, sup, args, argv.data(), argc, data))
+		{
+			return false;
+		}
+
+		const u64 offset = ::align(sizeof(deferred_record) + argc * sizeof(u64), 16);
+		const u64 size = ::align(offset + data.size(), 16);
+
+		if (size > deferred_buffer::size / 4)
+		{
+			return false;
+		}
+
+		deferred_buffer& buf = get_deferred_buffer();
+
+		buf.busy = true;
+
+		if (!s_deferred)
+		{
+			buf.busy = false;
+			return false;
+		}
+
+		u64 head, skip;
+
+		while (true)
+		{
+			head = buf.head;
+
+			// Records are never split at the end of the buffer
+			const u64 pos = head % deferred_buffer::size;
+			skip = pos + size > deferred_buffer::size ? deferred_buffer::size - pos : 0;
+
+			if (head + skip + size - buf.tail <= deferred_buffer::size)
+			{
+				break;
+			}
+
+			// Wait for the writer
+			s_deferred_writer->notify();
+			std::this_thread::yield();
+		}
+
+		if (skip)
+		{
+			reinterpret_cast<deferred_record*>(buf.data.get() + head % deferred_buffer::size)->size = 0;
+		}
+
+		uchar* const ptr = buf.data.get() + (head + skip) % deferred_buffer::size;
+
+		const auto rec = reinterpret_cast<deferred_record*>(ptr);
+		rec->size = static_cast<u32>(size);
+		rec->argc = argc;
+		rec->stamp = stamp;
+		rec->msg = msg;
+		rec->fmt = fmt;
+		rec->sup = sup;
+		rec->copy = copy;
+		rec->prefix = prefix;
+		std::memcpy(ptr + sizeof(deferred_record), argv.data(), argc * sizeof(u64));
+		std::memcpy(ptr + offset, data.data(), data.size());
+
+		buf.head = head + skip + size;
+
+		// Wake up the writer if it's going to sleep (it checks the buffers after setting the flag)
+		if (s_deferred_idle && s_deferred_idle.exchange(false))
+		{
+			s_deferred_writer->notify();
+		}
+
+		buf.busy = false;
+		return true;
+	}
+
+	// Get the oldest record of the buffer (writer only)
+	static const deferred_record* peek_deferred(deferred_buffer& buf, u64 head)
+	{
+		while (buf.tail < head)
+		{
+			const u64 pos = buf.tail % deferred_buffer::size;
+			const auto rec = reinterpret_cast<const deferred_record*>(buf.data.get() + pos);
+
+			if (rec->size)
+			{
+				return rec;
+			}
+
+			buf.tail += deferred_buffer::size - pos;
+		}
+
+		return nullptr;
+	}
+
+	// Replace data offsets with pointers to the copied strings and objects (writer only)
+	static void unpack_deferred_args(const u32* copy, const fmt_type_info* sup, const u64* argv, u32 argc, const uchar* data, std::vector<fmt_type_info>& out_sup, std::vector<u64>& out_args)
+	{
+		out_args.assign(argv, argv + argc);
+		out_args.push_back(0);
+		out_sup.assign(sup, sup + argc + 1);
+
+		for (u32 i = 0; i < argc; i++)
+		{
+			if (copy[i] != arg_raw)
+			{
+				out_args[i] = reinterpret_cast<std::uintptr_t>(data + argv[i]);
+			}
+
+			if (copy[i] == arg_string || copy[i] == arg_text)
+			{
+				out_sup[i] = fmt_type_info::make<const char*>();
+			}
+		}
+	}
+
+	// Format and send all messages recorded so far, ordered by timestamp (writer only)
+	static void drain_deferred()
+	{
+		std::vector<std::shared_ptr<deferred_buffer>> buffers;
+		{
+			semaphore_lock lock(s_deferred_mutex);
+			buffers = s_deferred_buffers;
+		}
+
+		std::vector<u64> heads;
+
+		for (const auto& buf : buffers)
+		{
+			heads.push_back(buf->head);
+		}
+
+		std::vector<u64> args;
+		std::vector<fmt_type_info> sup;
+		std::string prefix;
+		std::string text;
+
+		while (true)
+		{
+			std::size_t index = -1;
+			const deferred_record* rec = nullptr;
+
+			for (std::size_t i = 0; i < buffers.size(); i++)
+			{
+				if (const auto next = peek_deferred(*buffers[i], heads[i]))
+				{
+					if (!rec || next->stamp < rec->stamp)
+					{
+						index = i;
+						rec = next;
+					}
+				}
+			}
+
+			if (!rec)
+			{
+				break;
+			}
+
+			const auto argv = reinterpret_cast<const u64*>(rec + 1);
+			const auto data = reinterpret_cast<const uchar*>(rec) + ::align(sizeof(deferred_record) + rec->argc * sizeof(u64), 16);
+
+			u32 prefix_argc = 0;
+
+			while (rec->prefix.sup[prefix_argc].fmt_string)
+			{
+				prefix_argc++;
+			}
+
+			unpack_deferred_args(rec->prefix.copy, rec->prefix.sup, rec->prefix.args, prefix_argc, data, sup, args);
+			prefix.clear();
+			fmt::raw_append(prefix, rec->prefix.fmt, sup.data(), args.data());
+
+			unpack_deferred_args(rec->copy, rec->sup, argv, rec->argc, data, sup, args);
+			text.clear();
+			fmt::raw_append(text, rec->fmt, sup.data(), args.data());
+
+			rec->msg.send(rec->stamp, prefix, text);
+
+			buffers[index]->tail += rec->size;
+		}
+
+		// Release buffers of finished threads
+		buffers.clear();
+
+		semaphore_lock lock(s_deferred_mutex);
+
+		s_deferred_buffers.erase(std::remove_if(s_deferred_buffers.begin(), s_deferred_buffers.end(), [](const std::shared_ptr<deferred_buffer>& buf)
+		{
+			return buf.use_count() == 1 && buf->tail == buf->head;
+		}), s_deferred_buffers.end());
+	}
+
+	// Check whether some messages are waiting for the writer
+	static bool check_deferred()
+	{
+		semaphore_lock lock(s_deferred_mutex);
+
+		for (const auto& buf : s_deferred_buffers)
+		{
+			if (buf->tail < buf->head)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Wait until the writer processes all messages of the current thread
+	static void wait_deferred()
+	{
+		if (const auto& buf = s_deferred_buffer)
+		{
+			while (buf->tail < buf->head && s_deferred)
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void set_deferred(bool enabled)
+	{
+		if (enabled == s_deferred.load())
+		{
+			return;
+		}
+
+		if (enabled)
+		{
+			s_deferred_exit = false;
+
+			thread_ctrl::spawn(s_deferred_writer, "Log Writer", []()
+			{
+				while (true)
+				{
+					const bool exit = s_deferred_exit;
+
+					drain_deferred();
+
+					if (exit)
+					{
+						break;
+					}
+
+					// Sleep until notified by the producer which sees the flag
+					s_deferred_idle = true;
+
+					if (!s_deferred_exit && !check_deferred())
+					{
+						thread_ctrl::wait();
+					}
+
+					s_deferred_idle = false;
+				}
+			});
+
+			s_deferred = true;
+			return;
+		}
+
+		s_deferred = false;
+
+		{
+			// Wait for the messages being recorded
+			semaphore_lock lock(s_deferred_mutex);
+
+			for (const auto& buf : s_deferred_buffers)
+			{
+				while (buf->busy)
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		s_deferred_exit = true;
+		s_deferred_writer->notify();
+		s_deferred_writer->join();
+		s_deferred_writer.reset();
+	}
 }
 
 logs::listener::~listener()
@@ -238,7 +652,7 @@ void logs::listener::add(logs::listener* _new)
 	}
 }
 
-void logs::message::broadcast(const char* fmt, const fmt_type_info* sup, const u64* args)
+void logs::message::broadcast(const char* fmt, const fmt_type_info* sup, const u64* args, const u32* copy)
 {
 	// Get timestamp
 	const u64 stamp = get_stamp();
@@ -267,36 +681,45 @@ void logs::message::broadcast(const char* fmt, const fmt_type_info* sup, const u
 		}
 	}
 
+	if (s_deferred && g_init)
+	{
+		if (sev > level::error && push_deferred(*this, stamp, fmt, sup, args, copy))
+		{
+			return;
+		}
+
+		// Keep the order of messages sent from this thread
+		wait_deferred();
+	}
+
 	// Get text
 	thread_local std::string text; text.clear();
 	fmt::raw_append(text, fmt, sup, args);
 	std::string prefix = g_tls_log_prefix();
 
-	// Get first (main) listener
-	listener* lis = get_logger();
-
 	if (!g_init)
 	{
 		semaphore_lock lock(g_mutex);
 
 		if (!g_init)
 		{
-			while (lis)
-			{
-				lis->log(stamp, *this, prefix, text);
-				lis = lis->m_next;
-			}
+			send(stamp, prefix, text);
 
 			// Store message additionally
 			get_logger()->messages.emplace_back(stored_message{*this, stamp, std::move(prefix), text});
+			return;
 		}
 	}
 
-	// Send message to all listeners
-	while (lis)
+	send(stamp, prefix, text);
+}
+
+void logs::message::send(u64 stamp, const std::string& prefix, const std::string& text) const
+{
+	// Send message to all listeners, starting from the first (main) listener
+	for (listener* lis = get_logger(); lis; lis = lis->m_next)
 	{
 		lis->log(stamp, *this, prefix, text);
-		lis = lis->m_next;
 	}
 }
 
@@ -29,10 +29,61 @@ namespace logs
 		channel* ch;
 		level sev;
 
-		// Send log message to global logger instance
-		void broadcast(const char*, const fmt_type_info*, const u64*);
+		// Send log message to global logger instance (copy: argument handling for deferred formatting)
+		void broadcast(const char*, const fmt_type_info*, const u64*, const u32* copy);
+
+		// Send formatted message to all listeners
+		void send(u64 stamp, const std::string& prefix, const std::string& text) const;
+	};
+
+	// Argument handling for deferred formatting (other values: size of the trivially copyable object)
+	enum : u32
+	{
+		arg_raw = 0, // Value (integer, enum, float, pointer)
+		arg_cstr = UINT32_MAX, // C string (copied)
+		arg_string = UINT32_MAX - 1, // std::string (characters copied)
+		arg_opaque = UINT32_MAX - 2, // Object which can't be copied (the message is sent immediately)
+		arg_text = UINT32_MAX - 3, // Object formatted on record (refers to volatile data, such as guest memory)
+	};
+
+	template <typename T, typename = void>
+	struct arg_copy : std::integral_constant<u32, std::is_same<fmt_unveil_t<T>, const char*>::value ? arg_cstr : arg_raw>
+	{
+	};
+
+	template <typename T>
+	struct arg_copy<T, void_t<typename fmt_unveil<T>::u64_wrapper>> : std::integral_constant<u32,
+		std::is_same<T, std::string>::value ? arg_string :
+		std::is_trivially_copyable<T>::value && alignof(T) <= 16 && sizeof(T) <= 4096 ? sizeof(T) : arg_opaque>
+	{
 	};
 
+	template <typename... Args>
+	SAFE_BUFFERS FORCE_INLINE const u32* get_arg_copy()
+	{
+		// Constantly initialized list of argument handling (same order as fmt::get_type_info)
+		static constexpr u32 result[sizeof...(Args) + 1]{arg_copy<Args>::value...};
+
+		return result;
+	}
+
+	// Unformatted thread-specific message prefix (only raw values and C strings)
+	struct raw_prefix
+	{
+		const char* fmt;
+		const fmt_type_info* sup;
+		const u32* copy;
+		u64 args[4];
+	};
+
+	template <typename... Args>
+	SAFE_BUFFERS FORCE_INLINE raw_prefix make_prefix(const char* fmt, const Args&... args)
+	{
+		static_assert(sizeof...(Args) <= 4, "make_prefix: too many arguments");
+
+		return {fmt, fmt::get_type_info<fmt_unveil_t<Args>...>(), get_arg_copy<Args...>(), {fmt_unveil<Args>::get(args)...}};
+	}
+
 	class listener
 	{
 		// Next listener (linked list)
@@ -73,7 +124,7 @@ namespace logs
 		{
 			if (UNLIKELY(sev <= enabled))
 			{
-				message{this, sev}.broadcast(fmt, fmt::get_type_info<fmt_unveil_t<Args>...>(), fmt_args_t<Args...>{fmt_unveil<Args>::get(args)...});
+				message{this, sev}.broadcast(fmt, fmt::get_type_info<fmt_unveil_t<Args>...>(), fmt_args_t<Args...>{fmt_unveil<Args>::get(args)...}, get_arg_copy<Args...>());
 			}
 		}
 
@@ -110,6 +161,9 @@ namespace logs
 
 	// Log level control: register channel if necessary, set channel level
 	void set_level(const std::string&, level);
+
+	// Format messages (except errors) in the background thread, flush them when disabled
+	void set_deferred(bool enabled);
 }
 
 // Legacy:
@@ -7,8 +7,10 @@
 #include "Emu/Cell/lv2/sys_event.h"
 #include "Thread.h"
 #include "sysinfo.h"
+#include "StrUtil.h"
 #include <typeinfo>
 #include <thread>
+#include <map>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -1550,9 +1552,14 @@ extern atomic_t<u32> g_thread_count(0);
 thread_local DECLARE(thread_ctrl::g_tls_this_thread) = nullptr;
 
 extern thread_local std::string(*g_tls_log_prefix)();
+extern thread_local logs::raw_prefix(*g_tls_log_raw_prefix)();
 
 DECLARE(thread_ctrl::g_native_core_layout) { native_core_arrangement::undefined };
 
+// Affinity masks built by detect_cpu_layout() for native_core_arrangement::topology
+static u64 s_topology_masks[4]{}; // Indexed by thread_class
+static std::vector<u64> s_topology_spu_domains; // SPU cores split by cache domain
+
 void thread_ctrl::start(const std::shared_ptr<thread_ctrl>& ctrl, task_stack task)
 {
 #ifdef _WIN32
@@ -1611,6 +1618,11 @@ void thread_ctrl::initialize()
 		return g_tls_this_thread->m_name;
 	};
 
+	g_tls_log_raw_prefix = []
+	{
+		return logs::make_prefix("%s", g_tls_this_thread->m_name.c_str());
+	};
+
 	++g_thread_count;
 
 #ifdef _MSC_VER
@@ -1679,6 +1691,11 @@ void thread_ctrl::finalize(std::exception_ptr eptr) noexcept
 		return g_tls_this_thread->m_name;
 	};
 
+	g_tls_log_raw_prefix = []
+	{
+		return logs::make_prefix("%s", g_tls_this_thread->m_name.c_str());
+	};
+
 	LOG_NOTICE(GENERAL, "Thread time: %fs (%fGc); Faults: %u [rsx:%u, spu:%u];",
 		time / 1000000000.,
 		cycles / 1000000000.,
@@ -1843,6 +1860,78 @@ void thread_ctrl::join()
 	}
 }
 
+void thread_ctrl::parallel_for(const std::string& name, u32 total, const std::function<bool(u32)>& func)
+{
+	atomic_t<u32> next{0};
+	atomic_t<bool> stop{false};
+
+	// First exception thrown by func (rethrown after all workers are joined)
+	semaphore<> mutex;
+	std::exception_ptr exception;
+
+	auto worker = [&]()
+	{
+		try
+		{
+			for (u32 i; !stop && (i = next++) < total;)
+			{
+				if (!func(i))
+				{
+					stop = true;
+				}
+			}
+		}
+		catch (...)
+		{
+			stop = true;
+
+			semaphore_lock lock(mutex);
+
+			if (!exception)
+			{
+				exception = std::current_exception();
+			}
+		}
+	};
+
+	const u32 count = std::max<u32>(1, std::min<u32>(std::thread::hardware_concurrency(), total));
+
+	std::vector<std::shared_ptr<thread_ctrl>> workers(count);
+
+	// Workers refer to the locals, so all of them must be joined before leaving
+	auto join_all = [&]()
+	{
+		for (auto& thread : workers)
+		{
+			if (thread)
+			{
+				thread->join();
+			}
+		}
+	};
+
+	try
+	{
+		for (u32 i = 0; i < count; i++)
+		{
+			spawn(workers[i], fmt::format("%s %u", name, i), worker);
+		}
+	}
+	catch (...)
+	{
+		stop = true;
+		join_all();
+		throw;
+	}
+
+	join_all();
+
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
 void thread_ctrl::notify()
 {
 	if (!(m_signal & 1))
@@ -1899,11 +1988,248 @@ void thread_ctrl::test()
 	}
 }
 
+#ifdef __linux__
+// Parse sysfs CPU list ("0-3,8-11") as a mask (CPUs above 63 are ignored)
+static u64 parse_cpu_list(const std::string& list)
+{
+	u64 result = 0;
+
+	for (const auto& range : fmt::split(list, {","}))
+	{
+		const auto dash = range.find('-');
+		const u32 first = std::stoul(range.substr(0, dash));
+		const u32 last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+
+		for (u32 cpu = first; cpu <= last && cpu < 64; cpu++)
+		{
+			result |= 1ull << cpu;
+		}
+	}
+
+	return result;
+}
+
+static u64 read_cpu_list(const std::string& path)
+{
+	const fs::file file(path);
+	return file ? parse_cpu_list(file.to_string()) : 0;
+}
+
+// Build the affinity masks from /sys/devices/system/cpu, returns false if the topology is not available
+static bool detect_sysfs_topology()
+{
+	const std::string sys_cpu = "/sys/devices/system/cpu/";
+
+	const u64 online = read_cpu_list(sys_cpu + "online");
+
+	if (!online)
+	{
+		return false;
+	}
+
+	// Physical core, L3 cache domain and NUMA node masks of every logical CPU
+	struct core_info
+	{
+		u64 smt;
+		u64 cache;
+		u64 node;
+	};
+
+	std::vector<core_info> cores;
+
+	for (u32 cpu = 0; cpu < 64; cpu++)
+	{
+		if (~online & (1ull << cpu))
+		{
+			continue;
+		}
+
+		const std::string path = fmt::format("%scpu%u/", sys_cpu, cpu);
+
+		core_info info{};
+		info.smt = read_cpu_list(path + "topology/thread_siblings_list") & online;
+
+		if (~info.smt & (1ull << cpu))
+		{
+			return false;
+		}
+
+		if (info.smt & ((1ull << cpu) - 1))
+		{
+			// Not the first thread of its physical core
+			continue;
+		}
+
+		for (u32 index = 0;; index++)
+		{
+			const fs::file level(fmt::format("%scache/index%u/level", path, index));
+
+			if (!level)
+			{
+				break;
+			}
+
+			if (std::stoul(level.to_string()) == 3)
+			{
+				info.cache = read_cpu_list(fmt::format("%scache/index%u/shared_cpu_list", path, index)) & online;
+			}
+		}
+
+		for (const auto& entry : fs::dir(path))
+		{
+			if (entry.is_directory && entry.name.compare(0, 4, "node") == 0)
+			{
+				info.node = read_cpu_list(fmt::format("/sys/devices/system/node/%s/cpulist", entry.name)) & online;
+			}
+		}
+
+		// Missing data: the whole machine is one domain
+		info.cache = info.cache ? info.cache : online;
+		info.node = info.node ? info.node : online;
+		cores.emplace_back(info);
+	}
+
+	// Keep everything on the largest NUMA node if it's big enough
+	{
+		std::map<u64, u32> nodes;
+
+		for (const auto& core : cores)
+		{
+			nodes[core.node]++;
+		}
+
+		const auto largest = std::max_element(nodes.begin(), nodes.end(), [](const auto& a, const auto& b)
+		{
+			return a.second < b.second;
+		});
+
+		if (nodes.size() > 1 && largest->second >= 8)
+		{
+			const u64 node = largest->first;
+
+			cores.erase(std::remove_if(cores.begin(), cores.end(), [&](const core_info& core)
+			{
+				return core.node != node;
+			}), cores.end());
+		}
+	}
+
+	const u32 count = ::size32(cores);
+
+	if (count < 4)
+	{
+		// Not enough physical cores to separate anything
+		return false;
+	}
+
+	// Physical cores grouped by cache domain (ordered by CPU numbers)
+	std::map<u64, std::vector<u64>> domains;
+
+	for (const auto& core : cores)
+	{
+		domains[core.cache].emplace_back(core.smt);
+	}
+
+	u64 ppu_mask = 0, spu_mask = 0, rsx_mask = 0, general_mask = 0;
+
+	// Other threads may use every selected core (on the chosen NUMA node)
+	for (const auto& core : cores)
+	{
+		general_mask |= core.smt;
+	}
+
+	s_topology_spu_domains.clear();
+
+	// SPU cores: 6 SPUs, the last cache domains are preferred (lower CPUs are more likely to be used by the OS)
+	const u32 spu_cores = std::min<u32>(6, count / 2);
+
+	u32 reserved = 0;
+
+	for (auto it = domains.rbegin(); it != domains.rend() && reserved < spu_cores; ++it)
+	{
+		// Only whole domains are used, unless the domain is shared with other classes
+		if (domains.size() > 1 && reserved + it->second.size() + 2 <= count)
+		{
+			u64 domain = 0;
+
+			for (u64 core : it->second)
+			{
+				domain |= core;
+			}
+
+			s_topology_spu_domains.emplace_back(domain);
+			spu_mask |= domain;
+			reserved += ::size32(it->second);
+		}
+	}
+
+	if (reserved < spu_cores)
+	{
+		// Single domain (or too few cores): split physical cores, SPUs take the last ones
+		s_topology_spu_domains.clear();
+		spu_mask = 0;
+
+		for (u32 i = count - spu_cores; i < count; i++)
+		{
+			spu_mask |= cores[i].smt;
+		}
+
+		s_topology_spu_domains.emplace_back(spu_mask);
+	}
+
+	// RSX gets the first free physical core, PPU all the remaining ones
+	for (const auto& core : cores)
+	{
+		if (core.smt & spu_mask)
+		{
+			continue;
+		}
+
+		if (!rsx_mask)
+		{
+			rsx_mask = core.smt;
+		}
+		else
+		{
+			ppu_mask |= core.smt;
+		}
+	}
+
+	if (!ppu_mask)
+	{
+		ppu_mask = rsx_mask;
+	}
+
+	s_topology_masks[static_cast<u32>(thread_class::general)] = general_mask;
+	s_topology_masks[static_cast<u32>(thread_class::rsx)] = rsx_mask;
+	s_topology_masks[static_cast<u32>(thread_class::spu)] = spu_mask;
+	s_topology_masks[static_cast<u32>(thread_class::ppu)] = ppu_mask;
+
+	LOG_NOTICE(GENERAL, "CPU topology: %u physical cores in %u cache domains, PPU=0x%llx SPU=0x%llx RSX=0x%llx", count, domains.size(), ppu_mask, spu_mask, rsx_mask);
+	return true;
+}
+#endif
+
 void thread_ctrl::detect_cpu_layout()
 {
 	if (!g_native_core_layout.compare_and_swap_test(native_core_arrangement::undefined, native_core_arrangement::generic))
 		return;
 
+#ifdef __linux__
+	try
+	{
+		if (detect_sysfs_topology())
+		{
+			g_native_core_layout.store(native_core_arrangement::topology);
+			return;
+		}
+	}
+	catch (const std::exception& e)
+	{
+		LOG_ERROR(GENERAL, "Failed to read CPU topology: %s", e.what());
+	}
+#endif
+
 	const auto system_id = utils::get_system_info();
 	if (system_id.find("Ryzen") != std::string::npos)
 	{
@@ -1913,13 +2239,13 @@ void thread_ctrl::detect_cpu_layout()
 	// TODO: Detect hyperthreaded intel CPUs
 }
 
-u16 thread_ctrl::get_affinity_mask(thread_class group)
+u64 thread_ctrl::get_affinity_mask(thread_class group, u32 hint)
 {
 	detect_cpu_layout();
 
 	if (const auto thread_count = std::thread::hardware_concurrency())
 	{
-		const u16 all_cores_mask = thread_count < 16 ? (u16)(~(UINT16_MAX << thread_count)): UINT16_MAX;
+		const u64 all_cores_mask = thread_count < 64 ? ~(UINT64_MAX << thread_count) : UINT64_MAX;
 
 		switch (g_native_core_layout)
 		{
@@ -1928,9 +2254,19 @@ u16 thread_ctrl::get_affinity_mask(thread_class group)
 		{
 			return all_cores_mask;
 		}
+		case native_core_arrangement::topology:
+		{
+			if (group == thread_class::spu && hint)
+			{
+				// Co-locate SPUs of the same group
+				return s_topology_spu_domains[hint % s_topology_spu_domains.size()];
+			}
+
+			return s_topology_masks[static_cast<u32>(group)];
+		}
 		case native_core_arrangement::amd_ccx:
 		{
-			u16 spu_mask, ppu_mask, rsx_mask;
+			u64 spu_mask, ppu_mask, rsx_mask;
 			if (thread_count >= 16)
 			{
 				// Threadripper, R7
@@ -1986,7 +2322,7 @@ u16 thread_ctrl::get_affinity_mask(thread_class group)
 		}
 	}
 
-	return UINT16_MAX;
+	return UINT64_MAX;
 }
 
 void thread_ctrl::set_native_priority(int priority)
@@ -2022,7 +2358,7 @@ void thread_ctrl::set_native_priority(int priority)
 #endif
 }
 
-void thread_ctrl::set_thread_affinity_mask(u16 mask)
+void thread_ctrl::set_thread_affinity_mask(u64 mask)
 {
 #ifdef _WIN32
 	HANDLE _this_thread = GetCurrentThread();
@@ -2035,9 +2371,9 @@ void thread_ctrl::set_thread_affinity_mask(u16 mask)
 	cpu_set_t cs;
 	CPU_ZERO(&cs);
 
-	for (u32 core = 0; core < 16u; ++core)
+	for (u32 core = 0; core < 64u; ++core)
 	{
-		if ((u32)mask & (1u << core))
+		if (mask & (1ull << core))
 		{
 			CPU_SET(core, &cs);
 		}
@@ -6,6 +6,7 @@
 #include <exception>
 #include <string>
 #include <memory>
+#include <functional>
 
 #include "sema.h"
 #include "cond.h"
@@ -22,7 +23,8 @@ enum class native_core_arrangement : u32
 	undefined,
 	generic,
 	intel_ht,
-	amd_ccx
+	amd_ccx,
+	topology // Detected from the OS (SMT siblings, shared L3 caches, NUMA nodes)
 };
 
 enum class thread_class : u32
@@ -266,17 +268,21 @@ public:
 		thread_ctrl::start(out, std::forward<F>(func));
 	}
 
+	// Call func(index) for every index in [0, total) on a pool of named threads ("<name> N"), wait for completion.
+	// The workers stop taking new indices once func returns false.
+	static void parallel_for(const std::string& name, u32 total, const std::function<bool(u32)>& func);
+
 	// Detect layout
 	static void detect_cpu_layout();
 
-	// Returns a core affinity mask. Set whether to generate the high priority set or not
-	static u16 get_affinity_mask(thread_class group);
+	// Returns a core affinity mask (up to 64 logical CPUs). Threads with the same hint are kept in the same cache domain if possible
+	static u64 get_affinity_mask(thread_class group, u32 hint = 0);
 
 	// Sets the native thread priority
 	static void set_native_priority(int priority);
 
 	// Sets the preferred affinity mask for this thread
-	static void set_thread_affinity_mask(u16 mask);
+	static void set_thread_affinity_mask(u64 mask);
 };
 
 class named_thread
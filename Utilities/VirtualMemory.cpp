@@ -124,6 +124,16 @@ namespace utils
 #endif
 	}
 
+	bool memory_advise_huge(void* pointer, std::size_t size)
+	{
+#ifdef MADV_HUGEPAGE
+		return ::madvise(pointer, size, MADV_HUGEPAGE) != -1;
+#else
+		// Large pages on Windows can't be protected with 4 KiB granularity
+		return false;
+#endif
+	}
+
 	shm::shm(u32 size)
 		: m_size(::align(size, 0x10000))
 		, m_ptr(nullptr)
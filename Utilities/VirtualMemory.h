@@ -36,6 +36,9 @@ namespace utils
 	// Set memory protection
 	void memory_protect(void* pointer, std::size_t size, protection prot);
 
+	// Hint to back memory with huge pages (transparent huge pages on Linux), return false if not supported
+	bool memory_advise_huge(void* pointer, std::size_t size);
+
 	// Shared memory handle
 	class shm
 	{
@@ -1,5 +1,6 @@
 #pragma once
 #include <stdint.h>
+#include "xxhash.h"
 
 namespace rpcs3
 {
@@ -24,4 +25,10 @@ namespace rpcs3
 
 		return result;
 	}
+
+	// Fast 64-bit hash of a memory range (xxHash64), the seed can be used to chain several ranges
+	static inline uint64_t hash_range(const void* data, size_t size, uint64_t seed = 0)
+	{
+		return XXH64(data, size, seed);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "profiler.h"
+#include "Thread.h"
+#include "File.h"
+#include "StrFmt.h"
+#include "Log.h"
+
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <algorithm>
+
+namespace prof
+{
+	atomic_t<bool> g_enabled{false};
+
+	struct zone_record
+	{
+		const char* name;
+		u64 arg;
+		u64 start;
+		u64 end;
+	};
+
+	// Single producer (owner thread), single consumer (trace writer)
+	struct zone_buffer
+	{
+		static constexpr u64 size = 1 << 16;
+
+		std::string name;
+		u32 tid;
+		bool described = false;
+
+		atomic_t<u64> head{0};
+		atomic_t<u64> tail{0};
+		atomic_t<u64> dropped{0};
+
+		std::unique_ptr<zone_record[]> records{new zone_record[size]};
+	};
+
+	static std::mutex s_mutex;
+	static std::vector<std::shared_ptr<zone_buffer>> s_buffers;
+	static std::shared_ptr<thread_ctrl> s_writer;
+	static fs::file s_file;
+	static bool s_first_event;
+	static u32 s_last_tid = 0;
+	static u64 s_tsc_base;
+	static double s_tsc_per_us;
+
+	static thread_local std::shared_ptr<zone_buffer> s_buffer;
+
+	static zone_buffer& get_buffer()
+	{
+		if (!s_buffer)
+		{
+			s_buffer = std::make_shared<zone_buffer>();
+
+			std::lock_guard<std::mutex> lock(s_mutex);
+			s_buffer->tid = ++s_last_tid;
+
+			if (const auto thread = thread_ctrl::get_current())
+			{
+				s_buffer->name = thread->get_name();
+			}
+			else
+			{
+				s_buffer->name = fmt::format("Thread %u", s_buffer->tid);
+			}
+
+			s_buffers.emplace_back(s_buffer);
+		}
+
+		return *s_buffer;
+	}
+
+	void record(const char* name, u64 arg, u64 start, u64 end)
+	{
+		zone_buffer& buf = get_buffer();
+
+		const u64 pos = buf.head;
+
+		if (pos - buf.tail >= zone_buffer::size)
+		{
+			// Writer didn't keep up
+			buf.dropped++;
+			return;
+		}
+
+		buf.records[pos % zone_buffer::size] = {name, arg, start, end};
+		buf.head = pos + 1;
+	}
+
+	// Write all recorded zones to the file (called by the writer only)
+	static void drain()
+	{
+		std::vector<std::shared_ptr<zone_buffer>> buffers;
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			buffers = s_buffers;
+		}
+
+		std::string out;
+
+		auto separator = [&]()
+		{
+			out += s_first_event ? "\n" : ",\n";
+			s_first_event = false;
+		};
+
+		for (const auto& buf : buffers)
+		{
+			if (!buf->described)
+			{
+				std::string name;
+
+				for (char c : buf->name)
+				{
+					if (c == '"' || c == '\\')
+					{
+						name += '\\';
+					}
+
+					name += c;
+				}
+
+				separator();
+				fmt::append(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", buf->tid, name);
+				buf->described = true;
+			}
+
+			const u64 head = buf->head;
+
+			for (u64 pos = buf->tail; pos < head; pos++)
+			{
+				const zone_record& r = buf->records[pos % zone_buffer::size];
+				const double ts = (r.start - s_tsc_base) / s_tsc_per_us;
+				const double dur = (r.end - r.start) / s_tsc_per_us;
+
+				separator();
+				fmt::append(out, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"arg\":\"0x%llx\"}}", r.name, buf->tid, ts, dur, r.arg);
+			}
+
+			buf->tail = head;
+
+			if (const u64 dropped = buf->dropped.exchange(0))
+			{
+				LOG_WARNING(GENERAL, "Profiler: %llu zones dropped in thread '%s'", dropped, buf->name);
+			}
+		}
+
+		s_file.write(out);
+
+		// Release buffers of finished threads
+		buffers.clear();
+
+		std::lock_guard<std::mutex> lock(s_mutex);
+
+		s_buffers.erase(std::remove_if(s_buffers.begin(), s_buffers.end(), [](const std::shared_ptr<zone_buffer>& buf)
+		{
+			return buf.use_count() == 1 && buf->tail == buf->head;
+		}), s_buffers.end());
+	}
+
+	void start(const std::string& path)
+	{
+		if (g_enabled)
+		{
+			return;
+		}
+
+		if (!s_file.open(path, fs::rewrite))
+		{
+			LOG_ERROR(GENERAL, "Profiler: failed to create '%s' (%s)", path, fs::g_tls_error);
+			return;
+		}
+
+		// Calibrate TSC frequency
+		const auto time0 = std::chrono::steady_clock::now();
+		const u64 tsc0 = __rdtsc();
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		const u64 tsc1 = __rdtsc();
+		const auto time1 = std::chrono::steady_clock::now();
+
+		{
+			// Discard zones left from the previous session
+			std::lock_guard<std::mutex> lock(s_mutex);
+
+			for (const auto& buf : s_buffers)
+			{
+				buf->tail = buf->head.load();
+				buf->described = false;
+			}
+		}
+
+		s_tsc_base = tsc0;
+		s_tsc_per_us = (tsc1 - tsc0) / std::max<double>(1., std::chrono::duration<double, std::micro>(time1 - time0).count());
+		s_first_event = true;
+		s_file.write(std::string("{\"traceEvents\":["));
+
+		g_enabled = true;
+
+		thread_ctrl::spawn(s_writer, "Trace Writer", []()
+		{
+			while (g_enabled)
+			{
+				thread_ctrl::wait_for(100000);
+				drain();
+			}
+		});
+
+		LOG_NOTICE(GENERAL, "Profiler: writing trace to '%s'", path);
+	}
+
+	void stop()
+	{
+		if (!g_enabled.exchange(false))
+		{
+			return;
+		}
+
+		s_writer->notify();
+		s_writer->join();
+		s_writer.reset();
+
+		// Write remaining zones
+		drain();
+
+		s_file.write(std::string("\n]}\n"));
+		s_file.close();
+	}
+}
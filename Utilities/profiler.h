@@ -0,0 +1,51 @@
+#pragma once
+
+#include "types.h"
+#include "Atomic.h"
+
+#include <string>
+
+// Lightweight instrumentation: scoped zones are recorded with TSC timestamps
+// into per-thread ring buffers and written to a Chrome trace (JSON) file.
+namespace prof
+{
+	// Fast check, true only between start() and stop()
+	extern atomic_t<bool> g_enabled;
+
+	// Record finished zone in the current thread's buffer (name must be a string literal)
+	void record(const char* name, u64 arg, u64 start, u64 end);
+
+	// Begin writing zones to the trace file
+	void start(const std::string& path);
+
+	// Flush all buffers and finalize the trace file
+	void stop();
+
+	// Measures the time spent in the current scope
+	class scoped_zone final
+	{
+		const char* m_name;
+		u64 m_arg;
+		u64 m_start;
+
+	public:
+		explicit scoped_zone(const char* name, u64 arg = 0)
+			: m_name(g_enabled ? name : nullptr)
+			, m_arg(arg)
+			, m_start(m_name ? __rdtsc() : 0)
+		{
+		}
+
+		scoped_zone(const scoped_zone&) = delete;
+
+		scoped_zone& operator=(const scoped_zone&) = delete;
+
+		~scoped_zone()
+		{
+			if (m_name)
+			{
+				record(m_name, m_arg, m_start, __rdtsc());
+			}
+		}
+	};
+}
@@ -3,11 +3,9 @@
 #include "Emu/IdManager.h"
 #include "Emu/Cell/PPUModule.h"
 
-// STB_IMAGE_IMPLEMENTATION is already defined in stb_image.cpp
-#include <stb_image.h>
-
 #include "Emu/Cell/lv2/sys_fs.h"
 #include "cellGifDec.h"
+#include "image_decoder.h"
 
 logs::channel cellGifDec("cellGifDec");
 
@@ -28,6 +26,35 @@ using POutParam = vm::ptr<CellGifDecOutParam>;
 using PDataCtrlParam = vm::cptr<CellGifDecDataCtrlParam>;
 using PDataOutInfo = vm::ptr<CellGifDecDataOutInfo>;
 
+// Key for image_decoder jobs (separated from cellJpgDec and cellPngDec keys)
+static u64 gif_decoder_key(PSubHandle subHandle)
+{
+	return u64{1} << 32 | subHandle.addr();
+}
+
+// Copy the GIF file to a buffer
+static std::vector<u8> gif_read_source(PSubHandle subHandle)
+{
+	std::vector<u8> gif(subHandle->fileSize);
+
+	switch (subHandle->src.srcSelect)
+	{
+	case CELL_GIFDEC_BUFFER:
+		std::memcpy(gif.data(), subHandle->src.streamPtr.get_ptr(), gif.size());
+		break;
+
+	case CELL_GIFDEC_FILE:
+	{
+		auto file = idm::get<lv2_fs_object, lv2_file>(subHandle->fd);
+		file->file.seek(0);
+		file->file.read(gif.data(), gif.size());
+		break;
+	}
+	}
+
+	return gif;
+}
+
 s32 cellGifDecCreate(PPMainHandle mainHandle, PThreadInParam threadInParam, PThreadOutParam threadOutParam)
 {
 	UNIMPLEMENTED_FUNC(cellGifDec);
@@ -152,6 +179,9 @@ s32 cellGifDecSetParameter(PMainHandle mainHandle, PSubHandle subHandle, PInPara
 
 	*outParam = current_outParam;
 
+	// Start decoding now, cellGifDecDecodeData will pick up the result
+	fxm::get_always<image_decoder>()->prefetch(gif_decoder_key(subHandle), gif_read_source(subHandle));
+
 	return CELL_OK;
 }
 
@@ -166,102 +196,31 @@ s32 cellGifDecDecodeData(PMainHandle mainHandle, PSubHandle subHandle, vm::ptr<u
 
 	dataOutInfo->status = CELL_GIFDEC_DEC_STATUS_STOP;
 
-	const u32& fd = subHandle->fd;
-	const u64& fileSize = subHandle->fileSize;
-	const CellGifDecOutParam& current_outParam = subHandle->outParam; 
+	const CellGifDecOutParam& current_outParam = subHandle->outParam;
 
-	//Copy the GIF file to a buffer
-	std::unique_ptr<u8[]> gif(new u8[fileSize]);
+	// Use the image decoded ahead by cellGifDecSetParameter if possible
+	auto image = fxm::get_always<image_decoder>()->take(gif_decoder_key(subHandle));
 
-	switch (subHandle->src.srcSelect)
-	{
-	case CELL_GIFDEC_BUFFER:
-		std::memcpy(gif.get(), subHandle->src.streamPtr.get_ptr(), fileSize);
-		break;
-
-	case CELL_GIFDEC_FILE:
+	if (!image)
 	{
-		auto file = idm::get<lv2_fs_object, lv2_file>(fd);
-		file->file.seek(0);
-		file->file.read(gif.get(), fileSize);
-		break;
-	}
+		image = std::make_shared<image_decode_job>(gif_read_source(subHandle));
 	}
 
-	//Decode GIF file. (TODO: Is there any faster alternative? Can we do it without external libraries?)
-	int width, height, actual_components;
-	auto image = std::unique_ptr<unsigned char,decltype(&::free)>
-		(
-			stbi_load_from_memory(gif.get(), (s32)fileSize, &width, &height, &actual_components, 4),
-			&::free
-		);
+	image->wait();
 
-	if (!image)
+	if (!image->pixels)
 		return CELL_GIFDEC_ERROR_STREAM_FORMAT;
 
-	const int bytesPerLine = (u32)dataCtrlParam->outputBytesPerLine;
-	const char nComponents = 4;
-	uint image_size = width * height * nComponents;
+	const u32 bytesPerLine = dataCtrlParam->outputBytesPerLine;
 
 	switch((u32)current_outParam.outputColorSpace)
 	{
 	case CELL_GIFDEC_RGBA:
-	{
-		if (bytesPerLine > width * nComponents) // Check if we need padding
-		{
-			const int linesize = std::min(bytesPerLine, width * nComponents);
-			for (int i = 0; i < height; i++)
-			{
-				const int dstOffset = i * bytesPerLine;
-				const int srcOffset = width * nComponents * i;
-				memcpy(&data[dstOffset], &image.get()[srcOffset], linesize);
-			}
-		}
-		else
-		{
-			memcpy(data.get_ptr(), image.get(), image_size);
-		}
-	}
+		image_decoder::output(*image, data.get_ptr(), bytesPerLine, image_pixel_format::rgba, false);
 	break;
 
 	case CELL_GIFDEC_ARGB:
-	{
-		if (bytesPerLine > width * nComponents) // Check if we need padding
-		{
-			//TODO: find out if we can't do padding without an extra copy
-			const int linesize = std::min(bytesPerLine, width * nComponents);
-			char *output = (char *) malloc(linesize);
-			for (int i = 0; i < height; i++)
-			{
-				const int dstOffset = i * bytesPerLine;
-				const int srcOffset = width * nComponents * i;
-				for (int j = 0; j < linesize; j += nComponents)
-				{
-					output[j + 0] = image.get()[srcOffset + j + 3];
-					output[j + 1] = image.get()[srcOffset + j + 0];
-					output[j + 2] = image.get()[srcOffset + j + 1];
-					output[j + 3] = image.get()[srcOffset + j + 2];
-				}
-				memcpy(&data[dstOffset], output, linesize);
-			}
-			free(output);
-		}
-		else
-		{
-			uint* img = (uint*)new char[image_size];
-			uint* source_current = (uint*)&(image.get()[0]);
-			uint* dest_current = img;
-			for (uint i = 0; i < image_size / nComponents; i++) 
-			{
-				uint val = *source_current;
-				*dest_current = (val >> 24) | (val << 8); // set alpha (A8) as leftmost byte
-				source_current++;
-				dest_current++;
-			}
-			memcpy(data.get_ptr(), img, image_size); 
-			delete[] img;
-		}
-	}
+		image_decoder::output(*image, data.get_ptr(), bytesPerLine, image_pixel_format::argb, false);
 	break;
 
 	default:
@@ -283,6 +242,11 @@ s32 cellGifDecClose(PMainHandle mainHandle, PSubHandle subHandle)
 {
 	cellGifDec.warning("cellGifDecClose(mainHandle=*0x%x, subHandle=*0x%x)", mainHandle, subHandle);
 
+	if (const auto decoder = fxm::get<image_decoder>())
+	{
+		decoder->discard(gif_decoder_key(subHandle));
+	}
+
 	idm::remove<lv2_fs_object, lv2_file>(subHandle->fd);
 
 	vm::dealloc(subHandle.addr());
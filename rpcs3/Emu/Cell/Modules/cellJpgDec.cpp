@@ -3,14 +3,41 @@
 #include "Emu/IdManager.h"
 #include "Emu/Cell/PPUModule.h"
 
-// STB_IMAGE_IMPLEMENTATION is already defined in stb_image.cpp
-#include <stb_image.h>
-
 #include "Emu/Cell/lv2/sys_fs.h"
 #include "cellJpgDec.h"
+#include "image_decoder.h"
 
 logs::channel cellJpgDec("cellJpgDec");
 
+// Key for image_decoder jobs (separated from cellGifDec and cellPngDec keys)
+static u64 jpg_decoder_key(u32 subHandle)
+{
+	return u64{3} << 32 | subHandle;
+}
+
+// Copy the JPG file to a buffer
+static std::vector<u8> jpg_read_source(const CellJpgDecSubHandle& subHandle)
+{
+	std::vector<u8> jpg(subHandle.fileSize);
+
+	switch (subHandle.src.srcSelect)
+	{
+	case CELL_JPGDEC_BUFFER:
+		std::memcpy(jpg.data(), vm::base(subHandle.src.streamPtr), jpg.size());
+		break;
+
+	case CELL_JPGDEC_FILE:
+	{
+		auto file = idm::get<lv2_fs_object, lv2_file>(subHandle.fd);
+		file->file.seek(0);
+		file->file.read(jpg.data(), jpg.size());
+		break;
+	}
+	}
+
+	return jpg;
+}
+
 s32 cellJpgDecCreate(u32 mainHandle, u32 threadInParam, u32 threadOutParam)
 {
 	UNIMPLEMENTED_FUNC(cellJpgDec);
@@ -78,6 +105,11 @@ s32 cellJpgDecClose(u32 mainHandle, u32 subHandle)
 		return CELL_JPGDEC_ERROR_FATAL;
 	}
 
+	if (const auto decoder = fxm::get<image_decoder>())
+	{
+		decoder->discard(jpg_decoder_key(subHandle));
+	}
+
 	idm::remove<lv2_fs_object, lv2_file>(subHandle_data->fd);
 	idm::remove<CellJpgDecSubHandle>(subHandle);
 
@@ -174,107 +206,40 @@ s32 cellJpgDecDecodeData(u32 mainHandle, u32 subHandle, vm::ptr<u8> data, vm::cp
 		return CELL_JPGDEC_ERROR_FATAL;
 	}
 
-	const u32& fd = subHandle_data->fd;
-	const u64& fileSize = subHandle_data->fileSize;
-	const CellJpgDecOutParam& current_outParam = subHandle_data->outParam; 
+	const CellJpgDecOutParam& current_outParam = subHandle_data->outParam;
 
-	//Copy the JPG file to a buffer
-	std::unique_ptr<u8[]> jpg(new u8[fileSize]);
+	// Use the image decoded ahead by cellJpgDecSetParameter if possible
+	auto image = fxm::get_always<image_decoder>()->take(jpg_decoder_key(subHandle));
 
-	switch (subHandle_data->src.srcSelect)
-	{
-	case CELL_JPGDEC_BUFFER:
-		std::memcpy(jpg.get(), vm::base(subHandle_data->src.streamPtr), fileSize);
-		break;
-
-	case CELL_JPGDEC_FILE:
+	if (!image)
 	{
-		auto file = idm::get<lv2_fs_object, lv2_file>(fd);
-		file->file.seek(0);
-		file->file.read(jpg.get(), fileSize);
-		break;
-	}
+		image = std::make_shared<image_decode_job>(jpg_read_source(*subHandle_data));
 	}
 
-	//Decode JPG file. (TODO: Is there any faster alternative? Can we do it without external libraries?)
-	int width, height, actual_components;
-	auto image = std::unique_ptr<unsigned char,decltype(&::free)>
-		(
-			stbi_load_from_memory(jpg.get(), (s32)fileSize, &width, &height, &actual_components, 4),
-			&::free
-		);
+	image->wait();
 
-	if (!image)
+	if (!image->pixels)
 		return CELL_JPGDEC_ERROR_STREAM_FORMAT;
 
 	const bool flip = current_outParam.outputMode == CELL_JPGDEC_BOTTOM_TO_TOP;
-	const int bytesPerLine = (u32)dataCtrlParam->outputBytesPerLine;
-	size_t image_size = width * height;
+	const u32 bytesPerLine = dataCtrlParam->outputBytesPerLine;
+	size_t image_size = image->width * image->height;
 
 	switch((u32)current_outParam.outputColorSpace)
 	{
 	case CELL_JPG_RGB:
+		image_size *= 3;
+		image_decoder::output(*image, data.get_ptr(), bytesPerLine, image_pixel_format::rgb, flip);
+	break;
+
 	case CELL_JPG_RGBA:
-	{
-		const char nComponents = current_outParam.outputColorSpace == CELL_JPG_RGBA ? 4 : 3;
-		image_size *= nComponents;
-		if (bytesPerLine > width * nComponents || flip) //check if we need padding
-		{
-			const int linesize = std::min(bytesPerLine, width * nComponents);
-			for (int i = 0; i < height; i++)
-			{
-				const int dstOffset = i * bytesPerLine;
-				const int srcOffset = width * nComponents * (flip ? height - i - 1 : i);
-				memcpy(&data[dstOffset], &image.get()[srcOffset], linesize);
-			}
-		}
-		else
-		{
-			memcpy(data.get_ptr(), image.get(), image_size);
-		}
-	}
+		image_size *= 4;
+		image_decoder::output(*image, data.get_ptr(), bytesPerLine, image_pixel_format::rgba, flip);
 	break;
 
 	case CELL_JPG_ARGB:
-	{
-		const int nComponents = 4;
-		image_size *= nComponents;
-		if (bytesPerLine > width * nComponents || flip) //check if we need padding
-		{
-			//TODO: Find out if we can't do padding without an extra copy
-			const int linesize = std::min(bytesPerLine, width * nComponents);
-			char *output = (char *) malloc(linesize);
-			for (int i = 0; i < height; i++)
-			{
-				const int dstOffset = i * bytesPerLine;
-				const int srcOffset = width * nComponents * (flip ? height - i - 1 : i);
-				for (int j = 0; j < linesize; j += nComponents)
-				{
-					output[j + 0] = image.get()[srcOffset + j + 3];
-					output[j + 1] = image.get()[srcOffset + j + 0];
-					output[j + 2] = image.get()[srcOffset + j + 1];
-					output[j + 3] = image.get()[srcOffset + j + 2];
-				}
-				memcpy(&data[dstOffset], output, linesize);
-			}
-			free(output);
-		}
-		else
-		{
-			uint* img = (uint*)new char[image_size];
-			uint* source_current = (uint*)&(image.get()[0]);
-			uint* dest_current = img;
-			for (uint i = 0; i < image_size / nComponents; i++) 
-			{
-				uint val = *source_current;
-				*dest_current = (val >> 24) | (val << 8); // set alpha (A8) as leftmost byte
-				source_current++;
-				dest_current++;
-			}
-			memcpy(data.get_ptr(), img, image_size); 
-			delete[] img;
-		}
-	}
+		image_size *= 4;
+		image_decoder::output(*image, data.get_ptr(), bytesPerLine, image_pixel_format::argb, flip);
 	break;
 
 	case CELL_JPG_GRAYSCALE:
@@ -344,6 +309,9 @@ s32 cellJpgDecSetParameter(u32 mainHandle, u32 subHandle, vm::cptr<CellJpgDecInP
 
 	*outParam = current_outParam;
 
+	// Games usually open and configure several images before decoding them, so start decoding now
+	fxm::get_always<image_decoder>()->prefetch(jpg_decoder_key(subHandle), jpg_read_source(*subHandle_data));
+
 	return CELL_OK;
 }
 
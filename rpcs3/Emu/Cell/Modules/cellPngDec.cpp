@@ -6,6 +6,7 @@
 #include "Emu/Cell/lv2/sys_fs.h"
 #include "png.h"
 #include "cellPngDec.h"
+#include "image_decoder.h"
 
 #if PNG_LIBPNG_VER_MAJOR >= 1 && (PNG_LIBPNG_VER_MINOR < 5 \
 || (PNG_LIBPNG_VER_MINOR == 5 && PNG_LIBPNG_VER_RELEASE < 7))
@@ -45,6 +46,32 @@ using PCbControlDisp     = vm::cptr<CellPngDecCbCtrlDisp>;
 using PCbControlStream   = vm::cptr<CellPngDecCbCtrlStrm>;
 using PDispParam         = vm::ptr<CellPngDecDispParam>;
 
+// Key for image_decoder jobs (separated from cellJpgDec and cellGifDec keys)
+static u64 png_decoder_key(PStream stream)
+{
+	return u64{2} << 32 | stream.addr();
+}
+
+// Copy the whole PNG file to a buffer (without moving the libpng read position)
+static std::vector<u8> pngDecReadSource(const PngStream& stream)
+{
+	if (stream.buffer->file)
+	{
+		auto file = idm::get<lv2_fs_object, lv2_file>(stream.buffer->fd);
+
+		const u64 pos = file->file.pos();
+		std::vector<u8> png(file->file.size());
+		file->file.seek(0);
+		file->file.read(png.data(), png.size());
+		file->file.seek(pos);
+		return png;
+	}
+
+	std::vector<u8> png(stream.buffer->length);
+	std::memcpy(png.data(), stream.buffer->data.get_ptr(), png.size());
+	return png;
+}
+
 // Custom read function for libpng, so we could decode images from a buffer
 void pngDecReadBuffer(png_structp png_ptr, png_bytep out, png_size_t length)
 {
@@ -474,6 +501,8 @@ s32 pngDecOpen(ppu_thread& ppu, PHandle handle, PPStream png_stream, PSrc source
 		buffer->cursor = 8;
 	}
 
+	stream->stream_mode = !!control_stream;
+
 	// Set the custom read function for decoding
 	if (control_stream) 
 	{
@@ -508,6 +537,11 @@ s32 pngDecOpen(ppu_thread& ppu, PHandle handle, PPStream png_stream, PSrc source
 
 s32 pngDecClose(ppu_thread& ppu, PHandle handle, PStream stream)
 {
+	if (const auto decoder = fxm::get<image_decoder>())
+	{
+		decoder->discard(png_decoder_key(stream));
+	}
+
 	// Remove the file descriptor, if a file descriptor was used for decoding
 	if (stream->buffer->file)
 	{
@@ -671,7 +705,26 @@ s32 pngDecSetParameter(PStream stream, PInParam in_param, POutParam out_param, P
 	}
 
 	*out_param = stream->out_param;
-	
+
+	// Formats which stb_image produces exactly as libpng would (8-bit RGB(A) output without a fixed alpha fill)
+	const u32 components = in_param->outputColorSpace == CELL_PNGDEC_RGB ? 3 : 4;
+	const bool fixed_alpha = in_param->outputAlphaSelect == CELL_PNGDEC_FIX_ALPHA && !cellPngColorSpaceHasAlpha(stream->info.colorSpace) && cellPngColorSpaceHasAlpha(in_param->outputColorSpace);
+
+	if (!stream->stream_mode &&
+		in_param->outputBitDepth == 8 &&
+		(in_param->outputColorSpace == CELL_PNGDEC_RGB || in_param->outputColorSpace == CELL_PNGDEC_RGBA || in_param->outputColorSpace == CELL_PNGDEC_ARGB) &&
+		stream->out_param.outputComponents == components &&
+		stream->out_param.outputWidthByte == stream->out_param.outputWidth * components &&
+		(!fixed_alpha || (in_param->outputColorAlpha == 0xff && !png_get_valid(stream->png_ptr, stream->info_ptr, PNG_INFO_tRNS))))
+	{
+		// Games usually open and configure several images before decoding them, so start decoding now
+		fxm::get_always<image_decoder>()->prefetch(png_decoder_key(stream), pngDecReadSource(*stream));
+	}
+	else if (const auto decoder = fxm::get<image_decoder>())
+	{
+		decoder->discard(png_decoder_key(stream));
+	}
+
 	return CELL_OK;
 }
 
@@ -688,6 +741,10 @@ s32 pngDecodeData(ppu_thread& ppu, PHandle handle, PStream stream, vm::ptr<u8> d
 		fmt::throw_exception("Bytes per line less than expected output! Got: %d, expected: %d" HERE, bytes_per_line, stream->out_param.outputWidthByte);
 	}
 
+	// Claim the image prefetched by pngDecSetParameter (always claimed, so it doesn't outlive this call)
+	const auto decoder = fxm::get<image_decoder>();
+	const auto image = decoder ? decoder->take(png_decoder_key(stream)) : nullptr;
+
 	// partial decoding
 	if (cb_control_disp && stream->outputCounts > 0)
 	{
@@ -760,6 +817,26 @@ s32 pngDecodeData(ppu_thread& ppu, PHandle handle, PStream stream, vm::ptr<u8> d
 
 		freeMem();
 	}
+	else if (image)
+	{
+		// Use the image decoded ahead by pngDecSetParameter
+		image->wait();
+
+		if (!image->pixels || u32(image->width) != stream->out_param.outputWidth || u32(image->height) != stream->out_param.outputHeight)
+		{
+			return CELL_PNGDEC_ERROR_FATAL;
+		}
+
+		const bool flip = stream->out_param.outputMode == CELL_PNGDEC_BOTTOM_TO_TOP;
+
+		switch (stream->out_param.outputColorSpace)
+		{
+		case CELL_PNGDEC_RGB: image_decoder::output(*image, data.get_ptr(), bytes_per_line, image_pixel_format::rgb, flip); break;
+		case CELL_PNGDEC_RGBA: image_decoder::output(*image, data.get_ptr(), bytes_per_line, image_pixel_format::rgba, flip); break;
+		case CELL_PNGDEC_ARGB: image_decoder::output(*image, data.get_ptr(), bytes_per_line, image_pixel_format::argb, flip); break;
+		default: fmt::throw_exception("Unexpected colour space: %d" HERE, stream->out_param.outputColorSpace);
+		}
+	}
 	else
 	{
 		// Check if the image needs to be flipped
@@ -300,6 +300,9 @@ struct PngStream
 	u32 nextRow = 0;
 	bool endOfFile = false;
 
+	// Opened with stream control callbacks (decoded progressively by libpng)
+	bool stream_mode;
+
 	// Pixel packing value
 	be_t<s32> packing;
 	u32 passes;
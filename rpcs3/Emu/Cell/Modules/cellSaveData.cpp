@@ -1,5 +1,6 @@
 #include "stdafx.h"
 #include "Emu/System.h"
+#include "Emu/IdManager.h"
 #include "Emu/Cell/PPUModule.h"
 #include "Emu/Cell/Modules/cellSysutil.h"
 
@@ -7,8 +8,14 @@
 
 #include "Loader/PSF.h"
 #include "Utilities/StrUtil.h"
+#include "Utilities/GSL.h"
 
 #include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 
 logs::channel cellSaveData("cellSaveData");
@@ -55,6 +62,307 @@ namespace
 		CellSaveDataFileSet  fileSet;
 		CellSaveDataDoneGet  doneGet;
 	};
+
+	// Directory where save data is staged before replacing the save directory (sibling of base_dir)
+	std::string savedata_stage_dir(const std::string& base_dir)
+	{
+		return base_dir.substr(0, base_dir.size() - 1) + ".tmp/";
+	}
+
+	// Restore save directories left moved away by an interrupted write, remove incomplete copies
+	void savedata_recover(const std::string& base_dir)
+	{
+		const std::string stage_dir = savedata_stage_dir(base_dir);
+
+		for (const auto& entry : fs::dir(stage_dir))
+		{
+			if (!entry.is_directory || entry.name == "." || entry.name == "..")
+			{
+				continue;
+			}
+
+			if (entry.name.size() > 4 && entry.name.compare(entry.name.size() - 4, 4, ".old") == 0)
+			{
+				const std::string name = entry.name.substr(0, entry.name.size() - 4);
+
+				if (!fs::is_dir(base_dir + name) && fs::rename(stage_dir + entry.name, base_dir + name, false))
+				{
+					cellSaveData.warning("Restored save data directory %s after an interrupted write", name);
+					continue;
+				}
+			}
+
+			fs::remove_all(stage_dir + entry.name);
+		}
+	}
+
+	// Save data directory contents, read once per user directory and updated by savedata_op
+	struct savedata_index
+	{
+		struct record
+		{
+			bool has_sfo; // Directories without PARAM.SFO are counted, but not listed
+			SaveDataEntry entry;
+		};
+
+		std::mutex mutex;
+
+		// Base directory -> save directory name -> record
+		std::unordered_map<std::string, std::map<std::string, record>> dirs;
+
+		// Base directories checked for interrupted writes
+		std::unordered_set<std::string> recovered;
+
+		// Restore interrupted writes once per base directory (mutex must be locked)
+		void recover(const std::string& base_dir)
+		{
+			if (recovered.emplace(base_dir).second)
+			{
+				savedata_recover(base_dir);
+			}
+		}
+
+		static record load(const std::string& base_dir, const std::string& name, const fs::stat_t& info)
+		{
+			record r{};
+
+			const psf::registry psf = psf::load_object(fs::file(base_dir + name + "/PARAM.SFO"));
+
+			if (!(r.has_sfo = !psf.empty()))
+			{
+				return r;
+			}
+
+			SaveDataEntry& entry = r.entry;
+			entry.dirName = psf.at("SAVEDATA_DIRECTORY").as_string();
+			entry.listParam = psf.at("SAVEDATA_LIST_PARAM").as_string();
+			entry.title = psf.at("TITLE").as_string();
+			entry.subtitle = psf.at("SUB_TITLE").as_string();
+			entry.details = psf.at("DETAIL").as_string();
+
+			entry.size = 0;
+
+			for (const auto& file : fs::dir(base_dir + name))
+			{
+				entry.size += file.size;
+			}
+
+			entry.atime = info.atime;
+			entry.mtime = info.mtime;
+			entry.ctime = info.ctime;
+			if (fs::file icon{base_dir + name + "/ICON0.PNG"})
+				entry.iconBuf = icon.to_vector<uchar>();
+			entry.isNew = false;
+			return r;
+		}
+
+		// Get all directories in the base directory (mutex must be locked)
+		const std::map<std::string, record>& get(const std::string& base_dir)
+		{
+			const auto found = dirs.find(base_dir);
+
+			if (found != dirs.end())
+			{
+				return found->second;
+			}
+
+			auto& index = dirs[base_dir];
+
+			recover(base_dir);
+
+			for (auto&& entry : fs::dir(base_dir))
+			{
+				if (!entry.is_directory)
+				{
+					continue;
+				}
+
+				entry.name = vfs::unescape(entry.name);
+				index.emplace(entry.name, load(base_dir, entry.name, entry));
+			}
+
+			return index;
+		}
+
+		// Reload the save directory after it was created, modified or deleted
+		void update(const std::string& base_dir, const std::string& name)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			const auto found = dirs.find(base_dir);
+
+			if (found == dirs.end())
+			{
+				return;
+			}
+
+			fs::stat_t info;
+
+			if (fs::stat(base_dir + name, info) && info.is_directory)
+			{
+				found->second[name] = load(base_dir, name, info);
+			}
+			else
+			{
+				found->second.erase(name);
+			}
+		}
+	};
+
+	// Background save data writer: the new directory contents are staged and fsynced, then replace the old directory
+	class savedata_writer final : public named_thread
+	{
+	public:
+		struct job
+		{
+			std::string base_dir;
+			std::string dir_name;
+
+			// File name -> new contents (nullptr: deleted), other files are kept
+			std::map<std::string, std::shared_ptr<std::vector<uchar>>> files;
+		};
+
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_cv; // Signaled when the queue is empty
+		std::deque<job> m_queue;
+
+		std::string get_name() const override { return "Save Data Writer"; }
+
+		static bool commit(const job& _job)
+		{
+			const std::string stage_dir = savedata_stage_dir(_job.base_dir);
+			const std::string dir_path = _job.base_dir + _job.dir_name;
+			const std::string new_path = stage_dir + _job.dir_name;
+			const std::string old_path = stage_dir + _job.dir_name + ".old";
+
+			fs::remove_all(new_path);
+
+			if (!fs::create_path(new_path))
+			{
+				cellSaveData.error("savedata_writer: failed to create %s (%s)", new_path, fs::g_tls_error);
+				return false;
+			}
+
+			auto fail = [&](const std::string& path)
+			{
+				cellSaveData.error("savedata_writer: failed to write %s (%s)", path, fs::g_tls_error);
+				fs::remove_all(new_path);
+				return false;
+			};
+
+			// Copy unchanged files
+			for (const auto& entry : fs::dir(dir_path))
+			{
+				if (entry.is_directory || _job.files.count(entry.name))
+				{
+					continue;
+				}
+
+				if (!fs::copy_file(dir_path + '/' + entry.name, new_path + '/' + entry.name, true))
+				{
+					return fail(new_path + '/' + entry.name);
+				}
+			}
+
+			for (const auto& file : _job.files)
+			{
+				if (!file.second)
+				{
+					continue;
+				}
+
+				fs::file out(new_path + '/' + file.first, fs::rewrite);
+
+				if (!out || out.write(file.second->data(), file.second->size()) != file.second->size())
+				{
+					return fail(new_path + '/' + file.first);
+				}
+
+				out.sync();
+			}
+
+			// Replace the directory, the old one is restored by savedata_recover() if interrupted in between
+			fs::remove_all(old_path);
+
+			if (fs::is_dir(dir_path) && !fs::rename(dir_path, old_path, false))
+			{
+				return fail(dir_path);
+			}
+
+			if (!fs::rename(new_path, dir_path, false))
+			{
+				fs::rename(old_path, dir_path, false);
+				return fail(dir_path);
+			}
+
+			fs::remove_all(old_path);
+			return true;
+		}
+
+		void on_task() override
+		{
+			while (true)
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+
+				if (m_queue.empty())
+				{
+					m_cv.notify_all();
+
+					// Pending writes are always completed before exiting
+					if (Emu.IsStopped())
+					{
+						break;
+					}
+
+					lock.unlock();
+					thread_ctrl::wait_for(10000);
+					continue;
+				}
+
+				const job& next = m_queue.front();
+				lock.unlock();
+
+				if (commit(next))
+				{
+					cellSaveData.notice("savedata_writer: %s written (%u files)", next.dir_name, next.files.size());
+				}
+
+				if (const auto index = fxm::get<savedata_index>())
+				{
+					index->update(next.base_dir, next.dir_name);
+				}
+
+				lock.lock();
+				m_queue.pop_front();
+			}
+		}
+
+	public:
+		void on_stop() override
+		{
+			notify();
+			join();
+		}
+
+		void push(job&& _job)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_queue.emplace_back(std::move(_job));
+			}
+
+			notify();
+		}
+
+		// Wait until all queued writes are completed
+		void wait()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cv.wait(lock, [&] { return m_queue.empty(); });
+		}
+	};
 }
 
 vm::gvar<savedata_context> g_savedata_context;
@@ -73,6 +381,12 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 		return CELL_SAVEDATA_ERROR_BUSY;
 	}
 
+	// Wait for the previous save to be written, so the directory contents are up to date
+	if (const auto writer = fxm::get<savedata_writer>())
+	{
+		writer->wait();
+	}
+
 	*g_savedata_context = {};
 
 	vm::ptr<CellSaveDataCBResult> result   = g_savedata_context.ptr(&savedata_context::result);
@@ -91,6 +405,12 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 
 	result->userdata = userdata; // probably should be assigned only once (allows the callback to change it)
 
+	const auto index = fxm::get_always<savedata_index>();
+	{
+		std::lock_guard<std::mutex> index_lock(index->mutex);
+		index->recover(base_dir);
+	}
+
 	SaveDataEntry save_entry;
 
 	if (setList)
@@ -104,58 +424,30 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 
 		const auto prefix_list = fmt::split(setList->dirNamePrefix.get_ptr(), {"|"});
 
-		// get the saves matching the supplied prefix
-		for (auto&& entry : fs::dir(base_dir))
+		// get the saves matching the supplied prefix (from the index, the directory is only read once)
 		{
-			if (!entry.is_directory)
-			{
-				continue;
-			}
+			std::lock_guard<std::mutex> index_lock(index->mutex);
 
-			entry.name = vfs::unescape(entry.name);
-
-			for (const auto& prefix : prefix_list)
+			for (const auto& pair : index->get(base_dir))
 			{
-				if (entry.name.substr(0, prefix.size()) == prefix)
+				for (const auto& prefix : prefix_list)
 				{
-					// Count the amount of matches and the amount of listed directories
-					listGet->dirNum++; // total number of directories
-					if (listGet->dirListNum < setBuf->dirListMax)
+					if (pair.first.compare(0, prefix.size(), prefix) == 0)
 					{
-						listGet->dirListNum++; // number of directories in list
-
-						// PSF parameters
-						const psf::registry psf = psf::load_object(fs::file(base_dir + entry.name + "/PARAM.SFO"));
-
-						if (psf.empty())
+						// Count the amount of matches and the amount of listed directories
+						listGet->dirNum++; // total number of directories
+						if (listGet->dirListNum < setBuf->dirListMax)
 						{
-							break;
-						}
-
-						SaveDataEntry save_entry2;
-						save_entry2.dirName = psf.at("SAVEDATA_DIRECTORY").as_string();
-						save_entry2.listParam = psf.at("SAVEDATA_LIST_PARAM").as_string();
-						save_entry2.title = psf.at("TITLE").as_string();
-						save_entry2.subtitle = psf.at("SUB_TITLE").as_string();
-						save_entry2.details = psf.at("DETAIL").as_string();
-
-						save_entry2.size = 0;
+							listGet->dirListNum++; // number of directories in list
 
-						for (const auto entry2 : fs::dir(base_dir + entry.name))
-						{
-							save_entry2.size += entry2.size;
+							if (pair.second.has_sfo)
+							{
+								save_entries.emplace_back(pair.second.entry);
+							}
 						}
 
-						save_entry2.atime = entry.atime;
-						save_entry2.mtime = entry.mtime;
-						save_entry2.ctime = entry.ctime;
-						if (fs::file icon{base_dir + entry.name + "/ICON0.PNG"})
-							save_entry2.iconBuf = icon.to_vector<uchar>();
-						save_entry2.isNew = false;
-						save_entries.emplace_back(save_entry2);
+						break;
 					}
-
-					break;
 				}
 			}
 		}
@@ -343,6 +635,8 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 				doneGet->excResult = CELL_SAVEDATA_ERROR_FAILURE;
 			}
 
+			index->update(base_dir, save_entries[selected].dirName);
+
 			funcDone(ppu, result, doneGet);
 		};
 
@@ -470,6 +764,58 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 	std::string dir_path = base_dir + save_entry.dirName + "/";
 	std::string sfo_path = dir_path + "PARAM.SFO";
 
+	// Keep the index coherent with whatever happens to the directory below
+	auto update_index = gsl::finally([&]()
+	{
+		index->update(base_dir, save_entry.dirName);
+	});
+
+	// File changes are staged in memory and written by savedata_writer if enabled
+	const bool async_write = static_cast<bool>(g_cfg.vfs.async_savedata);
+
+	std::map<std::string, std::shared_ptr<std::vector<uchar>>> staged;
+
+	auto write_staged = gsl::finally([&]()
+	{
+		if (!staged.empty())
+		{
+			fxm::get_always<savedata_writer>()->push({base_dir, save_entry.dirName, std::move(staged)});
+		}
+	});
+
+	// Open staged file as a stream (the old contents are loaded from the disk if kept)
+	auto stage_file = [&](const std::string& name, bool keep) -> fs::file
+	{
+		const auto found = staged.find(name);
+
+		if (found != staged.end() && found->second)
+		{
+			if (!keep)
+			{
+				found->second->clear();
+			}
+
+			return fs::make_stream<std::vector<uchar>&>(*found->second);
+		}
+
+		if (!fs::is_dir(dir_path))
+		{
+			return fs::file{};
+		}
+
+		auto data = std::make_shared<std::vector<uchar>>();
+
+		if (keep && found == staged.end())
+		{
+			if (fs::file old{dir_path + name})
+			{
+				*data = old.to_vector<uchar>();
+			}
+		}
+
+		return fs::make_stream<std::vector<uchar>&>(*(staged[name] = std::move(data)));
+	};
+
 	psf::registry psf = psf::load_object(fs::file(sfo_path));
 
 	// Get save stats
@@ -754,7 +1100,19 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 		{
 		case CELL_SAVEDATA_FILEOP_READ:
 		{
-			fs::file file(dir_path + file_path, fs::read);
+			fs::file file;
+
+			const auto found = staged.find(file_path);
+
+			if (found == staged.end())
+			{
+				file.open(dir_path + file_path, fs::read);
+			}
+			else if (found->second)
+			{
+				file = fs::make_stream<std::vector<uchar>&>(*found->second);
+			}
+
 			if (!file)
 			{
 				// ****** sysutil savedata parameter error : 22 ******
@@ -787,7 +1145,7 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 
 		case CELL_SAVEDATA_FILEOP_WRITE:
 		{
-			fs::file file(dir_path + file_path, fs::write + fs::create);
+			fs::file file = async_write ? stage_file(file_path, fileSet->fileOffset != 0) : fs::file(dir_path + file_path, fs::write + fs::create);
 			if (!file)
 			{
 				fmt::throw_exception("Failed to open file. The file might be read-only: %s%s" HERE, dir_path, file_path);
@@ -803,14 +1161,22 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 
 		case CELL_SAVEDATA_FILEOP_DELETE:
 		{
-			fs::remove_file(dir_path + file_path);
+			if (async_write)
+			{
+				staged[file_path] = nullptr;
+			}
+			else
+			{
+				fs::remove_file(dir_path + file_path);
+			}
+
 			fileGet->excSize = 0;
 			break;
 		}
 
 		case CELL_SAVEDATA_FILEOP_WRITE_NOTRUNC:
 		{
-			fs::file file(dir_path + file_path, fs::write + fs::create);
+			fs::file file = async_write ? stage_file(file_path, true) : fs::file(dir_path + file_path, fs::write + fs::create);
 			if (!file)
 			{
 				fmt::throw_exception("Failed to open file. The file might be read-only: %s%s" HERE, dir_path, file_path);
@@ -834,7 +1200,7 @@ static NEVER_INLINE s32 savedata_op(ppu_thread& ppu, u32 operation, u32 version,
 	// Write PARAM.SFO
 	if (psf.size())
 	{
-		psf::save_object(fs::file(sfo_path, fs::rewrite), psf);
+		psf::save_object(async_write ? stage_file("PARAM.SFO", false) : fs::file(sfo_path, fs::rewrite), psf);
 	}
 
 	return CELL_OK;
@@ -846,6 +1212,11 @@ static NEVER_INLINE s32 savedata_get_list_item(vm::cptr<char> dirName, vm::ptr<C
 	{
 		userId = Emu.GetUsrId();
 	}
+	if (const auto writer = fxm::get<savedata_writer>())
+	{
+		writer->wait();
+	}
+
 	std::string save_path = vfs::get(fmt::format("/dev_hdd0/home/%08u/savedata/%s/", userId, dirName.get_ptr()));
 	std::string sfo = save_path + "PARAM.SFO";
 
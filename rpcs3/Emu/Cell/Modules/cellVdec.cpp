@@ -15,6 +15,7 @@ extern "C"
 
 #include "cellPamf.h"
 #include "cellVdec.h"
+#include "cellVpost.h"
 
 #include <mutex>
 #include <queue>
@@ -54,17 +55,85 @@ struct vdec_frame
 	u64 userdata;
 	u32 frc;
 
+	std::vector<u8> pic; // Picture converted ahead of cellVdecGetPicture
+	u64 pic_format{}; // Format key of the converted picture (0 if none)
+
 	AVFrame* operator ->() const
 	{
 		return avf.get();
 	}
 };
 
+// Pack picture format into a nonzero key
+static inline u64 vdec_pic_format_key(u32 type, u32 color_matrix, u8 alpha)
+{
+	return u64{1} << 63 | u64{type} << 32 | u64{color_matrix} << 8 | alpha;
+}
+
+static u32 vdec_pic_size(u32 type, int w, int h)
+{
+	switch (type)
+	{
+	case CELL_VDEC_PICFMT_ARGB32_ILV:
+	case CELL_VDEC_PICFMT_RGBA32_ILV: return w * h * 4;
+	case CELL_VDEC_PICFMT_UYVY422_ILV: return w * h * 2;
+	case CELL_VDEC_PICFMT_YUV420_PLANAR: return w * h * 3 / 2;
+	}
+
+	fmt::throw_exception("Unknown formatType (%d)" HERE, type);
+}
+
+static void vdec_convert_picture(SwsContext*& sws, const AVFrame* frame, u32 type, u32 color_matrix, u8 alpha, u8* out)
+{
+	const int w = frame->width;
+	const int h = frame->height;
+
+	if (color_matrix & ~1)
+	{
+		fmt::throw_exception("Unknown colorMatrixType (%d)" HERE, color_matrix);
+	}
+
+	if (frame->format != AV_PIX_FMT_YUV420P)
+	{
+		fmt::throw_exception("Unknown format (%d)" HERE, frame->format);
+	}
+
+	AVPixelFormat out_f = AV_PIX_FMT_YUV420P;
+
+	switch (type)
+	{
+	case CELL_VDEC_PICFMT_ARGB32_ILV:
+	case CELL_VDEC_PICFMT_RGBA32_ILV:
+	{
+		vpost_yuv420_to_rgb32(frame->data[0], frame->data[1], frame->data[2], frame->linesize[0], frame->linesize[1], out, w * 4, w, h, alpha,
+			type == CELL_VDEC_PICFMT_ARGB32_ILV, color_matrix == CELL_VDEC_COLOR_MATRIX_TYPE_BT709);
+		return;
+	}
+	case CELL_VDEC_PICFMT_UYVY422_ILV: out_f = AV_PIX_FMT_UYVY422; break;
+	case CELL_VDEC_PICFMT_YUV420_PLANAR: out_f = AV_PIX_FMT_YUV420P; break;
+
+	default:
+	{
+		fmt::throw_exception("Unknown formatType (%d)" HERE, type);
+	}
+	}
+
+	sws = sws_getCachedContext(sws, w, h, AV_PIX_FMT_YUV420P, w, h, out_f, SWS_POINT, NULL, NULL, NULL);
+
+	u8* in_data[4] = { frame->data[0], frame->data[1], frame->data[2] };
+	int in_line[4] = { frame->linesize[0], frame->linesize[1], frame->linesize[2] };
+	u8* out_data[4] = { out, out + w * h, out + w * h * 5 / 4 };
+	int out_line[4] = { w, w / 2, w / 2 };
+
+	sws_scale(sws, in_data, in_line, 0, h, out_data, out_line);
+}
+
 struct vdec_thread : ppu_thread
 {
 	AVCodec* codec{};
 	AVCodecContext* ctx{};
 	SwsContext* sws{};
+	SwsContext* sws_async{}; // Used by the decoder thread only
 
 	const s32 type;
 	const u32 profile;
@@ -81,8 +150,11 @@ struct vdec_thread : ppu_thread
 
 	std::mutex mutex;
 	std::queue<vdec_frame> out;
+	std::vector<std::vector<u8>> pic_pool; // Reusable buffers for converted pictures
 	u32 max_frames = 60;
 
+	atomic_t<u64> pic_format{0}; // Last format requested by cellVdecGetPicture
+
 	atomic_t<u32> au_count{0};
 
 	vdec_thread(s32 type, u32 profile, u32 addr, u32 size, vm::ptr<CellVdecCbMsg> func, u32 arg, u32 prio, u32 stack)
@@ -131,6 +203,13 @@ struct vdec_thread : ppu_thread
 			fmt::throw_exception("avcodec_alloc_context3() failed (type=0x%x)" HERE, type);
 		}
 
+		if (g_cfg.core.vdec_threads != 1)
+		{
+			// Let FFmpeg decode on several threads (0 means autodetect)
+			ctx->thread_count = g_cfg.core.vdec_threads;
+			ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+		}
+
 		AVDictionary* opts{};
 		av_dict_set(&opts, "refcounted_frames", "1", 0);
 
@@ -149,6 +228,34 @@ struct vdec_thread : ppu_thread
 		avcodec_close(ctx);
 		avcodec_free_context(&ctx);
 		sws_freeContext(sws);
+		sws_freeContext(sws_async);
+	}
+
+	// Convert the picture to the format requested last time, so that cellVdecGetPicture only needs to copy it
+	void convert_ahead(vdec_frame& frame)
+	{
+		const u64 format = pic_format;
+
+		if (!format || g_cfg.core.vdec_threads == 1)
+		{
+			return;
+		}
+
+		const u32 type = static_cast<u32>(format >> 32) & 0x7fffffff;
+		const u32 size = vdec_pic_size(type, frame->width, frame->height);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			if (!pic_pool.empty())
+			{
+				frame.pic = std::move(pic_pool.back());
+				pic_pool.pop_back();
+			}
+		}
+
+		frame.pic.resize(size);
+		vdec_convert_picture(sws_async, frame.avf.get(), type, static_cast<u32>(format >> 8) & 0xffffff, static_cast<u8>(format), frame.pic.data());
+		frame.pic_format = format;
 	}
 
 	virtual std::string dump() const override
@@ -226,7 +333,8 @@ struct vdec_thread : ppu_thread
 
 				while (max_frames)
 				{
-					if (vcmd == vdec_cmd::end_seq)
+					// Frame-threaded decoder holds delayed pictures which must be drained
+					if (vcmd == vdec_cmd::end_seq && !(ctx->active_thread_type & FF_THREAD_FRAME))
 					{
 						break;
 					}
@@ -354,6 +462,8 @@ struct vdec_thread : ppu_thread
 
 						cellVdec.trace("Got picture (pts=0x%llx[0x%llx], dts=0x%llx[0x%llx])", frame.pts, frame->pkt_pts, frame.dts, frame->pkt_dts);
 
+						convert_ahead(frame);
+
 						std::lock_guard<std::mutex>{mutex}, out.push(std::move(frame));
 
 						cb_func(*this, id, CELL_VDEC_MSG_TYPE_PICOUT, CELL_OK, cb_arg);
@@ -604,66 +714,21 @@ s32 cellVdecGetPicture(u32 handle, vm::cptr<CellVdecPicFormat> format, vm::ptr<u
 
 	if (outBuff)
 	{
-		const int w = frame->width;
-		const int h = frame->height;
-
-		AVPixelFormat out_f = AV_PIX_FMT_YUV420P;
-
-		std::unique_ptr<u8[]> alpha_plane;
-
-		switch (const u32 type = format->formatType)
-		{
-		case CELL_VDEC_PICFMT_ARGB32_ILV: out_f = AV_PIX_FMT_ARGB; alpha_plane.reset(new u8[w * h]); break;
-		case CELL_VDEC_PICFMT_RGBA32_ILV: out_f = AV_PIX_FMT_RGBA; alpha_plane.reset(new u8[w * h]); break;
-		case CELL_VDEC_PICFMT_UYVY422_ILV: out_f = AV_PIX_FMT_UYVY422; break;
-		case CELL_VDEC_PICFMT_YUV420_PLANAR: out_f = AV_PIX_FMT_YUV420P; break;
-
-		default:
-		{
-			fmt::throw_exception("Unknown formatType (%d)" HERE, type);
-		}
-		}
+		const u32 type = format->formatType;
+		const u32 color_matrix = format->colorMatrixType;
+		const u64 key = vdec_pic_format_key(type, color_matrix, format->alpha);
 
-		// TODO: color matrix
-		if (format->colorMatrixType & ~1)
+		if (frame.pic_format == key)
 		{
-			fmt::throw_exception("Unknown colorMatrixType (%d)" HERE, format->colorMatrixType);
+			std::memcpy(outBuff.get_ptr(), frame.pic.data(), frame.pic.size());
 		}
-
-		if (alpha_plane)
-		{
-			std::memset(alpha_plane.get(), format->alpha, w * h);
-		}
-
-		AVPixelFormat in_f = AV_PIX_FMT_YUV420P;
-
-		switch (frame->format)
+		else
 		{
-		case AV_PIX_FMT_YUV420P: in_f = alpha_plane ? AV_PIX_FMT_YUVA420P : AV_PIX_FMT_YUV420P; break;
-
-		default:
-		{
-			fmt::throw_exception("Unknown format (%d)" HERE, frame->format);
-		}
+			vdec_convert_picture(vdec->sws, frame.avf.get(), type, color_matrix, format->alpha, outBuff.get_ptr());
 		}
 
-		vdec->sws = sws_getCachedContext(vdec->sws, w, h, in_f, w, h, out_f, SWS_POINT, NULL, NULL, NULL);
-
-		u8* in_data[4] = { frame->data[0], frame->data[1], frame->data[2], alpha_plane.get() };
-		int in_line[4] = { frame->linesize[0], frame->linesize[1], frame->linesize[2], w * 1 };
-		u8* out_data[4] = { outBuff.get_ptr() };
-		int out_line[4] = { w * 4 };
-
-		if (!alpha_plane)
-		{
-			out_data[1] = out_data[0] + w * h;
-			out_data[2] = out_data[0] + w * h * 5 / 4;
-			out_line[0] = w;
-			out_line[1] = w / 2;
-			out_line[2] = w / 2;
-		}
-
-		sws_scale(vdec->sws, in_data, in_line, 0, h, out_data, out_line);
+		// Remember the format (validated by now) for the following pictures
+		vdec->pic_format = key;
 
 		//const u32 buf_size = align(av_image_get_buffer_size(vdec->ctx->pix_fmt, vdec->ctx->width, vdec->ctx->height, 1), 128);
 
@@ -676,6 +741,12 @@ s32 cellVdecGetPicture(u32 handle, vm::cptr<CellVdecPicFormat> format, vm::ptr<u
 		//}
 	}
 
+	if (!frame.pic.empty())
+	{
+		std::lock_guard<std::mutex> lock(vdec->mutex);
+		vdec->pic_pool.emplace_back(std::move(frame.pic));
+	}
+
 	return CELL_OK;
 }
 
@@ -12,6 +12,142 @@ extern "C"
 
 logs::channel cellVpost("cellVpost");
 
+namespace
+{
+	// YUV -> RGB coefficients (Q13)
+	struct yuv_matrix
+	{
+		s16 y, rv, gu, gv, bu;
+	};
+
+	const yuv_matrix s_bt601{9539, 13075, -3209, -6660, 16525};
+	const yuv_matrix s_bt709{9539, 14686, -1747, -4366, 17305};
+
+	inline u8 clamp_u8(s32 value)
+	{
+		return static_cast<u8>(value < 0 ? 0 : value > 255 ? 255 : value);
+	}
+
+	inline __m128i pair_epi16(s16 lo, s16 hi)
+	{
+		return _mm_set1_epi32(static_cast<s32>(static_cast<u16>(lo) | static_cast<u32>(static_cast<u16>(hi)) << 16));
+	}
+
+	// Convert 8 pixels (16-bit Y-16, U-128, V-128 lanes) to 16-bit R, G, B
+	inline void yuv_to_rgb_epi16(__m128i y, __m128i u, __m128i v, __m128i c_r, __m128i c_gu, __m128i c_gv, __m128i c_b, __m128i& r, __m128i& g, __m128i& b)
+	{
+		const __m128i round = _mm_set1_epi32(4096);
+		const __m128i one = _mm_set1_epi16(1);
+
+		const __m128i yv_lo = _mm_unpacklo_epi16(y, v);
+		const __m128i yv_hi = _mm_unpackhi_epi16(y, v);
+		const __m128i yu_lo = _mm_unpacklo_epi16(y, u);
+		const __m128i yu_hi = _mm_unpackhi_epi16(y, u);
+		const __m128i v1_lo = _mm_unpacklo_epi16(v, one);
+		const __m128i v1_hi = _mm_unpackhi_epi16(v, one);
+
+		r = _mm_packs_epi32(
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yv_lo, c_r), round), 13),
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yv_hi, c_r), round), 13));
+
+		// c_gv contains the rounding term in its high half
+		g = _mm_packs_epi32(
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_lo, c_gu), _mm_madd_epi16(v1_lo, c_gv)), 13),
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_hi, c_gu), _mm_madd_epi16(v1_hi, c_gv)), 13));
+
+		b = _mm_packs_epi32(
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_lo, c_b), round), 13),
+			_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(yu_hi, c_b), round), 13));
+	}
+}
+
+void vpost_yuv420_to_rgb32(const u8* y, const u8* u, const u8* v, u32 y_pitch, u32 uv_pitch, u8* out, u32 out_pitch, u32 width, u32 height, u8 alpha, bool argb, bool bt709)
+{
+	const yuv_matrix& m = bt709 ? s_bt709 : s_bt601;
+
+	const __m128i c_r = pair_epi16(m.y, m.rv);
+	const __m128i c_gu = pair_epi16(m.y, m.gu);
+	const __m128i c_gv = pair_epi16(m.gv, 4096);
+	const __m128i c_b = pair_epi16(m.y, m.bu);
+	const __m128i c_16 = _mm_set1_epi16(16);
+	const __m128i c_128 = _mm_set1_epi16(128);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i a = _mm_set1_epi8(static_cast<char>(alpha));
+
+	for (u32 row = 0; row < height; row++)
+	{
+		const u8* src_y = y + row * y_pitch;
+		const u8* src_u = u + (row / 2) * uv_pitch;
+		const u8* src_v = v + (row / 2) * uv_pitch;
+		u8* dst = out + row * out_pitch;
+
+		u32 x = 0;
+
+		for (; x + 16 <= width; x += 16)
+		{
+			const __m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_y + x));
+			const __m128i uc = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src_u + x / 2));
+			const __m128i vc = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src_v + x / 2));
+
+			// Duplicate chroma samples horizontally
+			const __m128i uu = _mm_unpacklo_epi8(uc, uc);
+			const __m128i vv = _mm_unpacklo_epi8(vc, vc);
+
+			__m128i r0, g0, b0, r1, g1, b1;
+
+			yuv_to_rgb_epi16(
+				_mm_sub_epi16(_mm_unpacklo_epi8(y8, zero), c_16),
+				_mm_sub_epi16(_mm_unpacklo_epi8(uu, zero), c_128),
+				_mm_sub_epi16(_mm_unpacklo_epi8(vv, zero), c_128),
+				c_r, c_gu, c_gv, c_b, r0, g0, b0);
+
+			yuv_to_rgb_epi16(
+				_mm_sub_epi16(_mm_unpackhi_epi8(y8, zero), c_16),
+				_mm_sub_epi16(_mm_unpackhi_epi8(uu, zero), c_128),
+				_mm_sub_epi16(_mm_unpackhi_epi8(vv, zero), c_128),
+				c_r, c_gu, c_gv, c_b, r1, g1, b1);
+
+			const __m128i r = _mm_packus_epi16(r0, r1);
+			const __m128i g = _mm_packus_epi16(g0, g1);
+			const __m128i b = _mm_packus_epi16(b0, b1);
+
+			// Interleave bytes in memory order (ARGB or RGBA)
+			const __m128i p0 = argb ? _mm_unpacklo_epi8(a, r) : _mm_unpacklo_epi8(r, g);
+			const __m128i p1 = argb ? _mm_unpackhi_epi8(a, r) : _mm_unpackhi_epi8(r, g);
+			const __m128i q0 = argb ? _mm_unpacklo_epi8(g, b) : _mm_unpacklo_epi8(b, a);
+			const __m128i q1 = argb ? _mm_unpackhi_epi8(g, b) : _mm_unpackhi_epi8(b, a);
+
+			__m128i* const dst_v = reinterpret_cast<__m128i*>(dst + x * 4);
+			_mm_storeu_si128(dst_v + 0, _mm_unpacklo_epi16(p0, q0));
+			_mm_storeu_si128(dst_v + 1, _mm_unpackhi_epi16(p0, q0));
+			_mm_storeu_si128(dst_v + 2, _mm_unpacklo_epi16(p1, q1));
+			_mm_storeu_si128(dst_v + 3, _mm_unpackhi_epi16(p1, q1));
+		}
+
+		for (; x < width; x++)
+		{
+			const s32 yy = (src_y[x] - 16) * m.y;
+			const s32 uu = src_u[x / 2] - 128;
+			const s32 vv = src_v[x / 2] - 128;
+
+			const u8 r = clamp_u8((yy + m.rv * vv + 4096) >> 13);
+			const u8 g = clamp_u8((yy + m.gu * uu + m.gv * vv + 4096) >> 13);
+			const u8 b = clamp_u8((yy + m.bu * uu + 4096) >> 13);
+
+			u8* const pixel = dst + x * 4;
+
+			if (argb)
+			{
+				pixel[0] = alpha, pixel[1] = r, pixel[2] = g, pixel[3] = b;
+			}
+			else
+			{
+				pixel[0] = r, pixel[1] = g, pixel[2] = b, pixel[3] = alpha;
+			}
+		}
+	}
+}
+
 s32 cellVpostQueryAttr(vm::cptr<CellVpostCfgParam> cfgParam, vm::ptr<CellVpostAttr> attr)
 {
 	cellVpost.warning("cellVpostQueryAttr(cfgParam=*0x%x, attr=*0x%x)", cfgParam, attr);
@@ -113,6 +249,13 @@ s32 cellVpostExec(u32 handle, vm::cptr<u8> inPicBuff, vm::cptr<CellVpostCtrlPara
 	picInfo->reserved1 = 0;
 	picInfo->reserved2 = 0;
 
+	if (ow == static_cast<u32>(w) && oh == h)
+	{
+		// No scaling required
+		vpost_yuv420_to_rgb32(&inPicBuff[0], &inPicBuff[w * h], &inPicBuff[w * h * 5 / 4], w, w / 2, outPicBuff.get_ptr(), ow * 4, w, h, ctrlParam->outAlpha, false, ctrlParam->inColorMatrix == CELL_VPOST_COLOR_MATRIX_BT709);
+		return CELL_OK;
+	}
+
 	//u64 stamp0 = get_system_time();
 	std::unique_ptr<u8[]> pA(new u8[w*h]);
 
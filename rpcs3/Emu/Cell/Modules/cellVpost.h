@@ -323,6 +323,9 @@ struct CellVpostPictureInfo
 	be_t<u32> reserved2;
 };
 
+// Convert YUV420 planar picture (limited range) to interleaved ARGB or RGBA with constant alpha
+void vpost_yuv420_to_rgb32(const u8* y, const u8* u, const u8* v, u32 y_pitch, u32 uv_pitch, u8* out, u32 out_pitch, u32 width, u32 height, u8 alpha, bool argb, bool bt709);
+
 class VpostInstance
 {
 public:
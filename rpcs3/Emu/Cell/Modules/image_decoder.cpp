@@ -0,0 +1,171 @@
+#include "stdafx.h"
+#include "Emu/System.h"
+
+// STB_IMAGE_IMPLEMENTATION is already defined in stb_image.cpp
+#include <stb_image.h>
+
+#include "image_decoder.h"
+
+#include <thread>
+
+void image_decode_job::run()
+{
+	if (!m_state.compare_and_swap_test(0, 1))
+	{
+		return;
+	}
+
+	int actual_components;
+	pixels.reset(stbi_load_from_memory(source.data(), ::narrow<int>(source.size(), HERE), &width, &height, &actual_components, 4));
+
+	// Compressed data is no longer needed
+	std::vector<u8>().swap(source);
+
+	std::lock_guard<std::mutex>{m_mutex}, m_state = 2;
+	m_cond.notify_all();
+}
+
+void image_decode_job::wait()
+{
+	run();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_cond.wait(lock, [&] { return m_state == 2; });
+}
+
+image_decoder::image_decoder()
+{
+	const u32 count = std::max<u32>(1, std::min<u32>(std::thread::hardware_concurrency() / 2, 4));
+
+	for (u32 i = 0; i < count; i++)
+	{
+		m_workers.emplace_back();
+		thread_ctrl::spawn(m_workers.back(), "Image Decoder " + std::to_string(i), [this] { worker(); });
+	}
+}
+
+void image_decoder::on_stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_exit = true;
+	}
+
+	m_cond.notify_all();
+
+	for (auto& thread : m_workers)
+	{
+		thread->join();
+	}
+}
+
+void image_decoder::worker()
+{
+	while (true)
+	{
+		std::shared_ptr<image_decode_job> job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cond.wait(lock, [&] { return m_exit || !m_queue.empty(); });
+
+			if (m_exit)
+			{
+				return;
+			}
+
+			job = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+
+		job->run();
+	}
+}
+
+void image_decoder::prefetch(u64 key, std::vector<u8>&& source)
+{
+	auto job = std::make_shared<image_decode_job>(std::move(source));
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs[key] = job;
+		m_queue.emplace_back(std::move(job));
+	}
+
+	m_cond.notify_one();
+}
+
+std::shared_ptr<image_decode_job> image_decoder::take(u64 key)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const auto found = m_jobs.find(key);
+
+	if (found == m_jobs.end())
+	{
+		return nullptr;
+	}
+
+	auto job = std::move(found->second);
+	m_jobs.erase(found);
+	return job;
+}
+
+void image_decoder::discard(u64 key)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_jobs.erase(key);
+}
+
+void image_decoder::output(const image_decode_job& image, u8* dst, u32 bytes_per_line, image_pixel_format format, bool flip)
+{
+	const u32 width = image.width;
+	const u32 height = image.height;
+	const u32 row_size = width * (format == image_pixel_format::rgb ? 3 : 4);
+	const u32 stride = std::max(bytes_per_line, row_size);
+
+	for (u32 y = 0; y < height; y++)
+	{
+		const u8* src = image.pixels.get() + width * 4 * (flip ? height - y - 1 : y);
+		u8* out = dst + y * stride;
+
+		switch (format)
+		{
+		case image_pixel_format::rgba:
+		{
+			std::memcpy(out, src, row_size);
+			break;
+		}
+		case image_pixel_format::argb:
+		{
+			u32 x = 0;
+
+			for (; x + 4 <= width; x += 4)
+			{
+				// Move alpha from the last byte to the first byte of every pixel
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), _mm_or_si128(_mm_slli_epi32(v, 8), _mm_srli_epi32(v, 24)));
+			}
+
+			for (; x < width; x++)
+			{
+				out[x * 4 + 0] = src[x * 4 + 3];
+				out[x * 4 + 1] = src[x * 4 + 0];
+				out[x * 4 + 2] = src[x * 4 + 1];
+				out[x * 4 + 3] = src[x * 4 + 2];
+			}
+
+			break;
+		}
+		case image_pixel_format::rgb:
+		{
+			for (u32 x = 0; x < width; x++)
+			{
+				out[x * 3 + 0] = src[x * 4 + 0];
+				out[x * 3 + 1] = src[x * 4 + 1];
+				out[x * 3 + 2] = src[x * 4 + 2];
+			}
+
+			break;
+		}
+		}
+	}
+}
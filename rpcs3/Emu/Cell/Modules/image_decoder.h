@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Utilities/Thread.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <unordered_map>
+
+// Pixel layouts written by image_decoder::output()
+enum class image_pixel_format : u32
+{
+	rgba,
+	argb,
+	rgb,
+};
+
+// Single image decoded to RGBA8 (using stb_image)
+class image_decode_job
+{
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	atomic_t<u32> m_state{0}; // 0 = queued, 1 = decoding, 2 = done
+
+public:
+	std::vector<u8> source;
+
+	std::unique_ptr<u8, decltype(&::free)> pixels{nullptr, &::free};
+	int width = 0;
+	int height = 0;
+
+	explicit image_decode_job(std::vector<u8>&& src)
+		: source(std::move(src))
+	{
+	}
+
+	// Decode the image unless it's already taken by another thread
+	void run();
+
+	// Wait for the result (decoding in the current thread if nobody started it yet)
+	void wait();
+};
+
+// Image decoding shared by cellJpgDec, cellGifDec and cellPngDec, with a worker pool for decoding ahead
+class image_decoder final
+{
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::deque<std::shared_ptr<image_decode_job>> m_queue;
+	std::unordered_map<u64, std::shared_ptr<image_decode_job>> m_jobs;
+	std::vector<std::shared_ptr<thread_ctrl>> m_workers;
+	bool m_exit = false;
+
+	void worker();
+
+public:
+	image_decoder();
+
+	void on_stop();
+
+	// Start decoding in background, the result is claimed later with take()
+	void prefetch(u64 key, std::vector<u8>&& source);
+
+	// Claim the job started by prefetch() (nullptr if none)
+	std::shared_ptr<image_decode_job> take(u64 key);
+
+	// Forget the job started by prefetch()
+	void discard(u64 key);
+
+	// Write decoded image to the output buffer (stride is at least the row size)
+	static void output(const image_decode_job& image, u8* dst, u32 bytes_per_line, image_pixel_format format, bool flip);
+};
@@ -141,17 +141,13 @@ error_code sys_lwmutex_lock(ppu_thread& ppu, vm::ptr<sys_lwmutex_t> lwmutex, u64
 		return CELL_EINVAL;
 	}
 
-	for (u32 i = 0; i < 10; i++)
+	// Spin or yield if the owner usually releases the lock soon
+	if (const auto queue = idm::get<lv2_obj, lv2_lwmutex>(lwmutex->sleep_queue))
 	{
-		busy_wait();
-
-		if (lwmutex->vars.owner.load() == lwmutex_free)
+		if (queue->spin.wait([&] { return lwmutex->vars.owner.load() == lwmutex_free && lwmutex->vars.owner.compare_and_swap_test(lwmutex_free, tid); }))
 		{
-			if (lwmutex->vars.owner.compare_and_swap_test(lwmutex_free, tid))
-			{
-				// locking succeeded
-				return CELL_OK;
-			}
+			// locking succeeded
+			return CELL_OK;
 		}
 	}
 
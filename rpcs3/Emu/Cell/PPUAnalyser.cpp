@@ -6,6 +6,7 @@
 #include <unordered_set>
 
 #include "yaml-cpp/yaml.h"
+#include "xxhash.h"
 
 
 
@@ -534,7 +535,195 @@ namespace ppu_patterns
 	};
 }
 
+// Insert address into sorted reference list (no duplicates)
+static void ppu_add_ref(std::vector<u32>& list, u32 addr)
+{
+	const auto found = std::lower_bound(list.begin(), list.end(), addr);
+
+	if (found == list.end() || *found != addr)
+	{
+		list.insert(found, addr);
+	}
+}
+
+// Analysis cache format version (must be incremented when the analyser changes)
+static constexpr u32 s_analysis_version = 1;
+
+static constexpr u32 s_analysis_magic = "PPUA"_u32;
+
+// Hash everything the analysis depends on
+static u64 ppu_analysis_hash(const ppu_module& info, u32 lib_toc, u32 entry)
+{
+	const u32 args[]{s_analysis_version, lib_toc, entry};
+
+	u64 hash = XXH64(args, sizeof(args), 0);
+
+	for (const auto& seg : info.segs)
+	{
+		hash = XXH64(&seg, sizeof(seg), hash);
+		hash = XXH64(vm::base(seg.addr), seg.size, hash);
+	}
+
+	for (const auto& sec : info.secs)
+	{
+		hash = XXH64(&sec, sizeof(sec), hash);
+	}
+
+	return XXH64(info.relocs.data(), info.relocs.size() * sizeof(ppu_reloc), hash);
+}
+
+bool ppu_module::load_analysis(const std::string& path, u64 hash)
+{
+	const fs::file file(path);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	const std::vector<u32> data = file.to_vector<u32>();
+
+	std::size_t pos = 0;
+	bool ok = true;
+
+	auto get = [&]() -> u32
+	{
+		if (pos >= data.size())
+		{
+			ok = false;
+			return 0;
+		}
+
+		return data[pos++];
+	};
+
+	if (get() != s_analysis_magic || get() != static_cast<u32>(hash) || get() != static_cast<u32>(hash >> 32))
+	{
+		return false;
+	}
+
+	const u32 count = get();
+
+	if (count > data.size())
+	{
+		return false;
+	}
+
+	std::vector<ppu_function> result(count);
+
+	for (ppu_function& func : result)
+	{
+		func.addr = get();
+		func.toc = get();
+		func.size = get();
+		func.attr = static_cast<bs_t<ppu_attr>>(get());
+		func.stack_frame = get();
+		func.trampoline = get();
+
+		const u32 blocks = get();
+		const u32 calls = get();
+		const u32 callers = get();
+		const u32 name = get();
+
+		if (!ok || u64{blocks} * 2 + calls + callers + (name + 3) / 4 > data.size() - pos)
+		{
+			return false;
+		}
+
+		for (u32 i = 0; i < blocks; i++)
+		{
+			const u32 addr = get();
+			func.blocks.emplace_hint(func.blocks.end(), addr, get());
+		}
+
+		func.calls.assign(data.begin() + pos, data.begin() + pos + calls);
+		pos += calls;
+		func.callers.assign(data.begin() + pos, data.begin() + pos + callers);
+		pos += callers;
+		func.name.assign(reinterpret_cast<const char*>(data.data() + pos), name);
+		pos += (name + 3) / 4;
+	}
+
+	if (!ok || pos != data.size())
+	{
+		return false;
+	}
+
+	funcs = std::move(result);
+	return true;
+}
+
+void ppu_module::save_analysis(const std::string& path, u64 hash) const
+{
+	std::vector<u32> data{s_analysis_magic, static_cast<u32>(hash), static_cast<u32>(hash >> 32), ::size32(funcs)};
+
+	for (const ppu_function& func : funcs)
+	{
+		data.insert(data.end(),
+		{
+			func.addr,
+			func.toc,
+			func.size,
+			static_cast<u32>(func.attr),
+			func.stack_frame,
+			func.trampoline,
+			::size32(func.blocks),
+			::size32(func.calls),
+			::size32(func.callers),
+			::size32(func.name),
+		});
+
+		for (const auto& block : func.blocks)
+		{
+			data.push_back(block.first);
+			data.push_back(block.second);
+		}
+
+		data.insert(data.end(), func.calls.begin(), func.calls.end());
+		data.insert(data.end(), func.callers.begin(), func.callers.end());
+
+		const std::size_t name_pos = data.size();
+		data.resize(name_pos + (func.name.size() + 3) / 4);
+		std::memcpy(data.data() + name_pos, func.name.data(), func.name.size());
+	}
+
+	// Write to the temporary file first, so an interrupted write never leaves a broken cache
+	const std::string tmp = path + ".tmp";
+
+	fs::file file;
+
+	if (!fs::create_path(fs::get_parent_dir(path)) || !file.open(tmp, fs::rewrite))
+	{
+		LOG_ERROR(PPU, "Failed to create analysis cache: %s (%s)", path, fs::g_tls_error);
+		return;
+	}
+
+	file.write(data);
+	file.close();
+
+	if (!fs::rename(tmp, path, true))
+	{
+		LOG_ERROR(PPU, "Failed to write analysis cache: %s (%s)", path, fs::g_tls_error);
+	}
+}
+
 void ppu_module::analyse(u32 lib_toc, u32 entry)
+{
+	const u64 hash = ppu_analysis_hash(*this, lib_toc, entry);
+
+	const std::string cache_path = fmt::format("%sdata/ppu-analysis/%s-%s.dat", fs::get_config_dir(), fmt::base57(sha1), path.substr(path.find_last_of('/') + 1));
+
+	if (load_analysis(cache_path, hash))
+	{
+		LOG_NOTICE(PPU, "Function analysis: %zu functions loaded from cache", funcs.size());
+		return;
+	}
+
+	analyse_funcs(lib_toc, entry);
+	save_analysis(cache_path, hash);
+}
+
+void ppu_module::analyse_funcs(u32 lib_toc, u32 entry)
 {
 	// Assume first segment is executable
 	const u32 start = segs[0].addr;
@@ -561,7 +750,7 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 		if (caller)
 		{
 			// Register caller
-			func.callers.emplace(caller);
+			ppu_add_ref(func.callers, caller);
 		}
 
 		if (func.addr)
@@ -899,7 +1088,7 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 					func.size = 0x4;
 					func.blocks.emplace(func.addr, func.size);
 					func.attr += new_func.attr & ppu_attr::no_return;
-					func.calls.emplace(target);
+					ppu_add_ref(func.calls, target);
 					func.trampoline = 0;
 					continue;
 				}
@@ -927,7 +1116,7 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 					func.size = 0x10;
 					func.blocks.emplace(func.addr, func.size);
 					func.attr += new_func.attr & ppu_attr::no_return;
-					func.calls.emplace(target);
+					ppu_add_ref(func.calls, target);
 					func.trampoline = 0;
 					continue;
 				}
@@ -974,7 +1163,7 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 					func.size = 0x10;
 					func.blocks.emplace(func.addr, func.size);
 					func.attr += new_func.attr & ppu_attr::no_return;
-					func.calls.emplace(target);
+					ppu_add_ref(func.calls, target);
 					func.trampoline = toc_add;
 					continue;
 				}
@@ -1306,7 +1495,7 @@ void ppu_module::analyse(u32 lib_toc, u32 entry)
 					{
 						if (target < func.addr || target >= func.addr + func.size)
 						{
-							func.calls.emplace(target);
+							ppu_add_ref(func.calls, target);
 							add_func(target, func.toc ? func.toc + func.trampoline : 0, func.addr);
 						}
 					}
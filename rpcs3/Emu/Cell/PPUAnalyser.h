@@ -2,7 +2,7 @@
 
 #include <string>
 #include <map>
-#include <set>
+#include <vector>
 
 #include "Utilities/bit_set.h"
 #include "Utilities/BEType.h"
@@ -31,8 +31,8 @@ struct ppu_function
 	u32 trampoline = 0;
 
 	std::map<u32, u32> blocks; // Basic blocks: addr -> size
-	std::set<u32> calls; // Set of called functions
-	std::set<u32> callers;
+	std::vector<u32> calls; // Called functions (sorted)
+	std::vector<u32> callers; // Calling functions (sorted)
 	std::string name; // Function name
 };
 
@@ -88,7 +88,12 @@ struct ppu_module
 		secs = info.secs;
 	}
 
+	// Find functions (the result is cached on disk by module hash)
 	void analyse(u32 lib_toc, u32 entry);
+	void analyse_funcs(u32 lib_toc, u32 entry);
+	bool load_analysis(const std::string& path, u64 hash);
+	void save_analysis(const std::string& path, u64 hash) const;
+
 	void validate(u32 reloc);
 };
 
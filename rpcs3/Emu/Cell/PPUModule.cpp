@@ -915,6 +915,12 @@ std::shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object& elf, const std::stri
 		}
 	}
 
+	prx->name = path.substr(path.find_last_of('/') + 1);
+	prx->path = path;
+
+	// Module hash (also used by analysis cache)
+	sha1_finish(&sha, prx->sha1);
+
 	if (!elf.progs.empty() && elf.progs[0].p_paddr)
 	{
 		struct ppu_prx_library_info
@@ -955,10 +961,6 @@ std::shared_ptr<lv2_prx> ppu_load_prx(const ppu_prx_object& elf, const std::stri
 	prx->exit.set(prx->specials[0x3ab9a95e]);
 	prx->prologue.set(prx->specials[0x0d10fd3f]);
 	prx->epilogue.set(prx->specials[0x330f7005]);
-	prx->name = path.substr(path.find_last_of('/') + 1);
-	prx->path = path;
-
-	sha1_finish(&sha, prx->sha1);
 
 	// Format patch name
 	std::string hash("PRX-0000000000000000000000000000000000000000");
@@ -1393,9 +1395,22 @@ void ppu_load_exec(const ppu_exec_object& elf)
 				"\nVisit https://rpcs3.net/ for Quickstart Guide and more information.");
 		}
 
-		for (const auto& name : load_libs)
+		// Decrypt and parse all modules in parallel
+		const std::vector<std::string> lib_list(load_libs.begin(), load_libs.end());
+
+		std::vector<ppu_prx_object> objs(lib_list.size());
+
+		thread_ctrl::parallel_for("SPRX Decrypter", ::size32(objs), [&](u32 i)
 		{
-			const ppu_prx_object obj = decrypt_self(fs::file(lle_dir + name));
+			objs[i].open(decrypt_self(fs::file(lle_dir + lib_list[i])));
+			return true;
+		});
+
+		// Load and link modules serially in the original order (keeps addresses deterministic)
+		for (std::size_t i = 0; i < lib_list.size(); i++)
+		{
+			const std::string& name = lib_list[i];
+			const ppu_prx_object& obj = objs[i];
 
 			if (obj == elf_error::ok)
 			{
@@ -1419,6 +1434,9 @@ void ppu_load_exec(const ppu_exec_object& elf)
 			{
 				fmt::throw_exception("Failed to load /dev_flash/sys/external/%s: %s", name, obj.get_error());
 			}
+
+			// Release decrypted data
+			objs[i] = {};
 		}
 	}
 
@@ -64,6 +64,8 @@ const bool s_use_ssse3 =
 #define _mm_shuffle_epi8
 #endif
 
+const ppu_decoder<ppu_itype> s_ppu_itype;
+
 extern u64 get_system_time();
 
 extern atomic_t<const char*> g_progr;
@@ -229,6 +231,34 @@ static bool ppu_check_toc(ppu_thread& ppu, ppu_opcode_t op)
 	return false;
 }
 
+using ppu_inter_func_t = decltype(&ppu_interpreter::UNK);
+
+struct ppu_block
+{
+	u32 addr;
+	u32 epoch;
+	std::vector<ppu_inter_func_t> ops; // Handlers (opcodes are read from memory, code may be patched)
+};
+
+// Pre-decoded basic blocks for the interpreters
+struct ppu_block_cache
+{
+	shared_mutex mutex;
+	std::unordered_map<u32, std::unique_ptr<ppu_block>> map;
+	std::vector<std::pair<u64, std::unique_ptr<ppu_block>>> retired; // Replaced blocks (may still be executed) and their retire generation
+	atomic_t<u32> epoch{0}; // Incremented on any executable cache modification
+	atomic_t<u64> gen{1}; // Incremented when a block is retired
+};
+
+// Invalidate all blocks built from the executable cache
+static void ppu_invalidate_blocks()
+{
+	if (const auto blocks = fxm::get<ppu_block_cache>())
+	{
+		blocks->epoch++;
+	}
+}
+
 extern void ppu_register_range(u32 addr, u32 size)
 {
 	if (!size)
@@ -249,6 +279,8 @@ extern void ppu_register_range(u32 addr, u32 size)
 		addr += 4;
 		size -= 4;
 	}
+
+	ppu_invalidate_blocks();
 }
 
 extern void ppu_register_function_at(u32 addr, u32 size, ppu_function_t ptr)
@@ -257,6 +289,7 @@ extern void ppu_register_function_at(u32 addr, u32 size, ppu_function_t ptr)
 	if (ptr)
 	{
 		ppu_ref(addr) = ::narrow<u32>(reinterpret_cast<std::uintptr_t>(ptr));
+		ppu_invalidate_blocks();
 		return;
 	}
 
@@ -332,6 +365,8 @@ extern void ppu_breakpoint(u32 addr, bool isAdding)
 		// Remove breakpoint
 		ppu_ref(addr) = ppu_cache(addr);
 	}
+
+	ppu_invalidate_blocks();
 }
 
 void ppu_thread::on_spawn()
@@ -378,6 +413,7 @@ extern void ppu_set_breakpoint(u32 addr)
 	if (ppu_ref(addr) != _break)
 	{
 		ppu_ref(addr) = _break;
+		ppu_invalidate_blocks();
 	}
 }
 
@@ -394,6 +430,7 @@ extern void ppu_remove_breakpoint(u32 addr)
 	if (ppu_ref(addr) == _break)
 	{
 		ppu_ref(addr) = ppu_cache(addr);
+		ppu_invalidate_blocks();
 	}
 }
 
@@ -424,9 +461,164 @@ extern bool ppu_patch(u32 addr, u32 value)
 		ppu_ref(addr) = ppu_cache(addr);
 	}
 
+	ppu_invalidate_blocks();
 	return true;
 }
 
+// Compare followed by the conditional branch
+template <ppu_inter_func_t Cmp>
+static bool ppu_block_cmp_bc(ppu_thread& ppu, ppu_opcode_t op)
+{
+	Cmp(ppu, op);
+	ppu.cia += 4;
+	return ppu_interpreter::BC(ppu, {vm::read32(ppu.cia)});
+}
+
+static std::unique_ptr<ppu_block> ppu_build_block(u32 addr, u32 epoch)
+{
+	auto block = std::make_unique<ppu_block>();
+	block->addr = addr;
+	block->epoch = epoch;
+
+	const auto get_func = [](u32 func)
+	{
+		return reinterpret_cast<ppu_inter_func_t>(std::uintptr_t{func});
+	};
+
+	// Compare instructions which can be fused with the following BC
+	const std::pair<ppu_inter_func_t, ppu_inter_func_t> fusable[]
+	{
+		{&ppu_interpreter::CMPI, &ppu_block_cmp_bc<&ppu_interpreter::CMPI>},
+		{&ppu_interpreter::CMPLI, &ppu_block_cmp_bc<&ppu_interpreter::CMPLI>},
+		{&ppu_interpreter::CMP, &ppu_block_cmp_bc<&ppu_interpreter::CMP>},
+		{&ppu_interpreter::CMPL, &ppu_block_cmp_bc<&ppu_interpreter::CMPL>},
+	};
+
+	for (u32 pos = addr;; pos += 4)
+	{
+		// Stop at special entries (unregistered code, breakpoints, TOC checks, HLE functions)
+		const u32 func = ppu_ref(pos);
+
+		if (func != ppu_cache(pos))
+		{
+			break;
+		}
+
+		const ppu_opcode_t op{vm::read32(pos)};
+
+		switch (s_ppu_itype.decode(op.opcode))
+		{
+		case ppu_itype::BC:
+		{
+			ppu_inter_func_t bc = get_func(func);
+
+			// Fuse with the preceding compare (the branch has no separate entry)
+			if (!block->ops.empty() && bc == &ppu_interpreter::BC)
+			{
+				for (const auto& pair : fusable)
+				{
+					if (block->ops.back() == pair.first)
+					{
+						block->ops.back() = pair.second;
+						bc = nullptr;
+						break;
+					}
+				}
+			}
+
+			if (bc)
+			{
+				block->ops.push_back(bc);
+			}
+
+			break;
+		}
+		case ppu_itype::B:
+		case ppu_itype::BCLR:
+		case ppu_itype::BCCTR:
+		case ppu_itype::SC:
+		case ppu_itype::TD:
+		case ppu_itype::TDI:
+		case ppu_itype::TW:
+		case ppu_itype::TWI:
+		{
+			block->ops.push_back(get_func(func));
+			break;
+		}
+		default:
+		{
+			block->ops.push_back(get_func(func));
+
+			// Limit block size, don't cross page boundary
+			if (block->ops.size() < 64 && (pos + 4) % 4096)
+			{
+				continue;
+			}
+		}
+		}
+
+		break;
+	}
+
+	if (block->ops.empty())
+	{
+		return nullptr;
+	}
+
+	return block;
+}
+
+// Find or build the block (returns nullptr if the instruction at addr must be executed separately)
+static const ppu_block* ppu_get_block(ppu_block_cache& blocks, u32 addr)
+{
+	const u32 epoch = blocks.epoch;
+
+	{
+		reader_lock lock(blocks.mutex);
+
+		const auto found = blocks.map.find(addr);
+
+		if (found != blocks.map.end() && found->second->epoch == epoch)
+		{
+			return found->second.get();
+		}
+	}
+
+	auto block = ppu_build_block(addr, epoch);
+
+	if (!block)
+	{
+		return nullptr;
+	}
+
+	// Get the oldest retire generation seen by the threads at a block boundary (obtained without the lock, may be outdated)
+	u64 passed = UINT64_MAX;
+
+	idm::select<ppu_thread>([&](u32, ppu_thread& ppu)
+	{
+		passed = std::min<u64>(passed, ppu.block_gen);
+	});
+
+	writer_lock lock(blocks.mutex);
+
+	// Free retired blocks which are no longer referenced by any thread
+	blocks.retired.erase(std::remove_if(blocks.retired.begin(), blocks.retired.end(), [&](const auto& pair)
+	{
+		return pair.first <= passed;
+	}), blocks.retired.end());
+
+	auto& ptr = blocks.map[addr];
+
+	if (ptr)
+	{
+		// Other threads may still execute the old block
+		blocks.retired.emplace_back(++blocks.gen, std::move(ptr));
+	}
+
+	ptr = std::move(block);
+	return ptr.get();
+}
+
 std::string ppu_thread::get_name() const
 {
 	return fmt::format("PPU[0x%x] Thread (%s)", id, m_name);
@@ -502,6 +694,7 @@ std::string ppu_thread::dump() const
 }
 
 extern thread_local std::string(*g_tls_log_prefix)();
+extern thread_local logs::raw_prefix(*g_tls_log_raw_prefix)();
 
 void ppu_thread::cpu_task()
 {
@@ -616,6 +809,75 @@ void ppu_thread::exec_task()
 	}
 
 	const auto base = vm::_ptr<const u8>(0);
+
+	if (g_cfg.core.ppu_block_interpreter)
+	{
+		const auto blocks = fxm::get_always<ppu_block_cache>();
+
+		if (!block_cache)
+		{
+			block_cache = std::make_unique<const ppu_block*[]>(1024);
+		}
+
+		// Nested call (callback from a syscall): the outer thread may still execute its block, don't advance
+		const u64 outer_gen = block_gen;
+
+		auto restore_gen = gsl::finally([&]()
+		{
+			block_gen = outer_gen;
+		});
+
+		// Blocks could be freed since the last call
+		block_cache_gen = 0;
+
+		while (true)
+		{
+			// Block boundary: forget the blocks retired since the last boundary
+			const u64 gen = blocks->gen;
+
+			if (UNLIKELY(gen != block_cache_gen))
+			{
+				std::fill_n(block_cache.get(), 1024, nullptr);
+				block_cache_gen = gen;
+
+				if (outer_gen == UINT64_MAX)
+				{
+					block_gen = gen;
+				}
+			}
+
+			if (UNLIKELY(test(state)))
+			{
+				if (check_state()) return;
+
+				// Decode single instruction (may be step)
+				const u32 op = *reinterpret_cast<const be_t<u32>*>(base + cia);
+				if (reinterpret_cast<ppu_inter_func_t>((std::uintptr_t)ppu_ref(cia))(*this, {op})) { cia += 4; }
+				continue;
+			}
+
+			auto& cached = block_cache[cia / 4 % 1024];
+
+			if (!cached || cached->addr != cia || cached->epoch != blocks->epoch)
+			{
+				cached = ppu_get_block(*blocks, cia);
+
+				if (!cached)
+				{
+					const u32 op = *reinterpret_cast<const be_t<u32>*>(base + cia);
+					if (reinterpret_cast<ppu_inter_func_t>((std::uintptr_t)ppu_ref(cia))(*this, {op})) { cia += 4; }
+					continue;
+				}
+			}
+
+			// Execute the whole block until a branch is taken or the end is reached
+			for (auto ptr = cached->ops.data(), end = ptr + cached->ops.size(); ptr != end && LIKELY((*ptr)(*this, {*reinterpret_cast<const be_t<u32>*>(base + cia)})); ptr++)
+			{
+				cia += 4;
+			}
+		}
+	}
+
 	const auto cache = vm::g_exec_addr;
 	const auto bswap4 = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
 
@@ -793,6 +1055,7 @@ void ppu_thread::fast_call(u32 addr, u32 rtoc)
 	const auto old_lr = lr;
 	const auto old_func = last_function;
 	const auto old_fmt = g_tls_log_prefix;
+	const auto old_raw_fmt = g_tls_log_raw_prefix;
 
 	cia = addr;
 	gpr[2] = rtoc;
@@ -806,6 +1069,13 @@ void ppu_thread::fast_call(u32 addr, u32 rtoc)
 		return fmt::format("%s [0x%08x]", _this->get_name(), _this->cia);
 	};
 
+	g_tls_log_raw_prefix = []
+	{
+		const auto _this = static_cast<ppu_thread*>(get_current_cpu_thread());
+
+		return logs::make_prefix("PPU[0x%x] Thread (%s) [0x%08x]", _this->id, _this->m_name.c_str(), _this->cia);
+	};
+
 	auto at_ret = gsl::finally([&]()
 	{
 		if (std::uncaught_exception())
@@ -832,6 +1102,7 @@ void ppu_thread::fast_call(u32 addr, u32 rtoc)
 			lr = old_lr;
 			last_function = old_func;
 			g_tls_log_prefix = old_fmt;
+			g_tls_log_raw_prefix = old_raw_fmt;
 		}
 	});
 
@@ -895,8 +1166,6 @@ void ppu_thread::stack_pop_verbose(u32 addr, u32 size) noexcept
 	LOG_ERROR(PPU, "Invalid thread" HERE);
 }
 
-const ppu_decoder<ppu_itype> s_ppu_itype;
-
 extern u64 get_timebased_time();
 extern ppu_function_t ppu_get_syscall(u64 code);
 
@@ -19,6 +19,9 @@ enum class ppu_cmd : u32
 	reset_stack, // resets stack address
 };
 
+// Pre-decoded instruction sequence (block interpreter)
+struct ppu_block;
+
 // Formatting helper
 enum class ppu_syscall_code : u64
 {
@@ -153,6 +156,10 @@ public:
 	u64 start_time{0}; // Sleep start timepoint
 	const char* last_function{}; // Last function name for diagnosis, optimized for speed.
 
+	std::unique_ptr<const ppu_block*[]> block_cache; // Direct-mapped block lookup table (block interpreter)
+	u64 block_cache_gen{0}; // Retire generation at the last block_cache reset
+	atomic_t<u64> block_gen{UINT64_MAX}; // Retire generation passed at a block boundary (-1 if not executing blocks)
+
 	const std::string m_name; // Thread name
 
 	be_t<u64>* get_stack_arg(s32 i, u64 align = alignof(u64));
@@ -24,6 +24,142 @@ const spu_decoder<spu_iname> s_spu_iname;
 
 extern u64 get_timebased_time();
 
+extern const spu_decoder<spu_interpreter_fast> g_spu_interpreter_fast;
+
+namespace
+{
+	// Background SPU compiler (asynchronous compilation)
+	class spu_compile_queue final : public named_thread
+	{
+		std::mutex m_mutex;
+
+		std::deque<std::vector<u32>> m_queue;
+
+		std::string get_name() const override { return "SPU Compiler"; }
+
+		void on_task() override
+		{
+			// Own recompiler instance, compiled functions are registered in the shared runtime
+			std::unique_ptr<spu_recompiler_base> compiler;
+
+			if (g_cfg.core.spu_decoder == spu_decoder_type::asmjit)
+			{
+				compiler = spu_recompiler_base::make_asmjit_recompiler();
+			}
+
+			if (g_cfg.core.spu_decoder == spu_decoder_type::llvm)
+			{
+				compiler = spu_recompiler_base::make_llvm_recompiler();
+			}
+
+			compiler->init();
+
+			// Fake LS (analysis state used by compile() is only filled by block() on the same instance)
+			std::vector<be_t<u32>> ls(0x10000);
+
+			while (!Emu.IsStopped())
+			{
+				std::vector<u32> func;
+				{
+					std::lock_guard<std::mutex> lock(m_mutex);
+
+					if (!m_queue.empty())
+					{
+						func = std::move(m_queue.front());
+						m_queue.pop_front();
+					}
+				}
+
+				if (func.empty())
+				{
+					thread_ctrl::wait_for(10000);
+					continue;
+				}
+
+				// Initialize LS with function data only
+				const u32 start = func[0] * (g_cfg.core.spu_block_size != spu_block_size_type::giga);
+
+				for (u32 i = 1, pos = start; i < func.size(); i++, pos += 4)
+				{
+					ls[pos / 4] = se_storage<u32>::swap(func[i]);
+				}
+
+				// Call analyser
+				std::vector<u32> func2 = compiler->block(ls.data(), func[0]);
+
+				if (func2.size() != func.size())
+				{
+					LOG_ERROR(SPU, "[0x%05x] SPU Analyser failed, %u vs %u", func2[0], func2.size() - 1, func.size() - 1);
+				}
+
+				// Clear fake LS
+				for (u32 i = 1, pos = start; i < func.size(); i++, pos += 4)
+				{
+					ls[pos / 4] = 0;
+				}
+
+				if (func2.size() != func.size())
+				{
+					std::memset(ls.data(), 0, 0x40000);
+				}
+
+				// Patches the runtime dispatcher when done (on failure, SPUs keep interpreting the block)
+				try
+				{
+					if (!compiler->compile(std::move(func2)))
+					{
+						LOG_ERROR(SPU, "[0x%05x] SPU Compiler failed", func[0]);
+					}
+				}
+				catch (const std::exception& e)
+				{
+					LOG_ERROR(SPU, "[0x%05x] SPU Compiler failed: %s", func[0], e.what());
+				}
+			}
+		}
+
+	public:
+		void on_stop() override
+		{
+			notify();
+			join();
+		}
+
+		void push(std::vector<u32>&& func)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_queue.emplace_back(std::move(func));
+			}
+
+			notify();
+		}
+	};
+}
+
+// Interpret until a taken branch reaches the code which is compiled or not queued yet
+static void spu_interpret_queued(SPUThread& spu)
+{
+	const auto& table = g_spu_interpreter_fast.get_table();
+	const auto base = spu._ptr<const u8>(0);
+
+	while (LIKELY(!test(spu.state)))
+	{
+		const u32 op = *reinterpret_cast<const be_t<u32>*>(base + spu.pc);
+
+		if (table[spu_decode(op)](spu, {op}))
+		{
+			spu.pc += 4;
+			continue;
+		}
+
+		if (spu.jit_queued[spu.pc / 4] != spu.jit->get(spu.pc))
+		{
+			return;
+		}
+	}
+}
+
 spu_cache::spu_cache(const std::string& loc)
 	: m_file(loc, fs::read + fs::write + fs::create)
 {
@@ -239,6 +375,19 @@ void spu_recompiler_base::dispatch(SPUThread& spu, void*, u8* rip)
 		return;
 	}
 
+	if (spu.jit_queued)
+	{
+		// Queue the block (once per runtime dispatcher change) and interpret it meanwhile
+		if (spu.jit_queued[spu.pc / 4] != func)
+		{
+			spu.jit_queued[spu.pc / 4] = func;
+			fxm::get_always<spu_compile_queue>()->push(spu.jit->block(spu._ptr<u32>(0), spu.pc));
+		}
+
+		spu_interpret_queued(spu);
+		return;
+	}
+
 	// Compile
 	verify(HERE), spu.jit->compile(spu.jit->block(spu._ptr<u32>(0), spu.pc));
 	spu.jit_dispatcher[spu.pc / 4] = spu.jit->get(spu.pc);
@@ -257,6 +406,17 @@ void spu_recompiler_base::dispatch(SPUThread& spu, void*, u8* rip)
 
 void spu_recompiler_base::branch(SPUThread& spu, void*, u8* rip)
 {
+	if (spu.jit_queued)
+	{
+		const auto func = spu.jit->get(spu.pc);
+
+		if (func == &dispatch || spu.jit_queued[spu.pc / 4] == func)
+		{
+			// Not compiled yet: leave the patch point and use the dispatcher
+			return dispatch(spu, nullptr, nullptr);
+		}
+	}
+
 	// Compile (TODO: optimize search of the existing functions)
 	const auto func = verify(HERE, spu.jit->compile(spu.jit->block(spu._ptr<u32>(0), spu.pc)));
 	spu.jit_dispatcher[spu.pc / 4] = spu.jit->get(spu.pc);
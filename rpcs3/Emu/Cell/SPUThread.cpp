@@ -2,6 +2,7 @@
 #include "Utilities/JIT.h"
 #include "Utilities/lockless.h"
 #include "Utilities/sysinfo.h"
+#include "Utilities/profiler.h"
 #include "Emu/Memory/vm.h"
 #include "Emu/System.h"
 
@@ -16,6 +17,7 @@
 #include "Emu/Cell/SPUDisAsm.h"
 #include "Emu/Cell/SPUThread.h"
 #include "Emu/Cell/SPUInterpreter.h"
+#include "Emu/Cell/SPUAnalyser.h"
 #include "Emu/Cell/SPURecompiler.h"
 #include "Emu/Cell/RawSPUThread.h"
 
@@ -355,6 +357,8 @@ void spu_int_ctrl_t::set(u64 ints)
 
 const spu_imm_table_t g_spu_imm;
 
+const spu_decoder<spu_itype> s_spu_itype;
+
 spu_imm_table_t::scale_table_t::scale_table_t()
 {
 	for (s32 i = -155; i < 174; i++)
@@ -396,7 +400,8 @@ void SPUThread::on_spawn()
 {
 	if (g_cfg.core.thread_scheduler_enabled)
 	{
-		thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::spu));
+		// Keep threads of the same group (like SPURS workers) in one cache domain
+		thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::spu, group ? group->id : 0));
 	}
 
 	if (g_cfg.core.lower_spu_priority)
@@ -501,6 +506,93 @@ void SPUThread::cpu_init()
 }
 
 extern thread_local std::string(*g_tls_log_prefix)();
+extern thread_local logs::raw_prefix(*g_tls_log_raw_prefix)();
+
+using spu_inter_func_t = decltype(&spu_interpreter::UNK);
+
+// Pre-decoded instruction sequence (block interpreter)
+struct spu_block
+{
+	struct op_t
+	{
+		spu_inter_func_t func;
+		spu_opcode_t op;
+	};
+
+	std::vector<u32> data; // Original instructions, must match LS contents on entry
+	std::vector<op_t> ops; // Terminated with spu_block_exit
+};
+
+static bool spu_block_exit(SPUThread&, spu_opcode_t)
+{
+	return false;
+}
+
+// Store which ends the block if it may overwrite the following instructions of the block
+template <spu_itype::type Type>
+static bool spu_block_store(SPUThread& spu, spu_opcode_t op)
+{
+	u32 addr = 0;
+
+	switch (Type)
+	{
+	case spu_itype::STQD: addr = (spu.gpr[op.ra]._s32[3] + (op.si10 << 4)) & 0x3fff0; spu_interpreter::STQD(spu, op); break;
+	case spu_itype::STQX: addr = (spu.gpr[op.ra]._u32[3] + spu.gpr[op.rb]._u32[3]) & 0x3fff0; spu_interpreter::STQX(spu, op); break;
+	case spu_itype::STQA: addr = spu_ls_target(0, op.i16); spu_interpreter::STQA(spu, op); break;
+	case spu_itype::STQR: addr = spu_ls_target(spu.pc, op.i16); spu_interpreter::STQR(spu, op); break;
+	default: break;
+	}
+
+	// The rest of the block is within [pc + 4, pc + 256)
+	if (addr + 16 > spu.pc + 4 && addr < spu.pc + 256)
+	{
+		spu.pc += 4;
+		return false;
+	}
+
+	return true;
+}
+
+static std::unique_ptr<spu_block> spu_build_block(const std::array<spu_inter_func_t, 2048>& table, const u8* base, u32 addr)
+{
+	auto block = std::make_unique<spu_block>();
+
+	for (u32 pos = addr; pos < 0x40000; pos += 4)
+	{
+		const u32 data = *reinterpret_cast<const u32*>(base + pos);
+		const u32 op = se_storage<u32>::swap(data);
+
+		const auto type = s_spu_itype.decode(op);
+
+		spu_inter_func_t func = table[spu_decode(op)];
+
+		switch (type)
+		{
+		case spu_itype::STQD: func = &spu_block_store<spu_itype::STQD>; break;
+		case spu_itype::STQX: func = &spu_block_store<spu_itype::STQX>; break;
+		case spu_itype::STQA: func = &spu_block_store<spu_itype::STQA>; break;
+		case spu_itype::STQR: func = &spu_block_store<spu_itype::STQR>; break;
+		default: break;
+		}
+
+		block->data.push_back(data);
+		block->ops.push_back({func, {op}});
+
+		// Stop at branches and channel instructions (DMA may overwrite the code), limit block size
+		if (type & spu_itype::branch || type == spu_itype::RDCH || type == spu_itype::WRCH || type == spu_itype::RCHCNT || type == spu_itype::STOP || type == spu_itype::STOPD)
+		{
+			break;
+		}
+
+		if (block->ops.size() >= 64)
+		{
+			break;
+		}
+	}
+
+	block->ops.push_back({&spu_block_exit, {}});
+	return block;
+}
 
 void SPUThread::cpu_task()
 {
@@ -519,6 +611,13 @@ void SPUThread::cpu_task()
 		return fmt::format("%s [0x%05x]", cpu->get_name(), cpu->pc);
 	};
 
+	g_tls_log_raw_prefix = []
+	{
+		const auto cpu = static_cast<SPUThread*>(get_current_cpu_thread());
+
+		return logs::make_prefix("%sSPU[0x%x] Thread (%s) [0x%05x]", cpu->offset >= RAW_SPU_BASE_ADDR ? "Raw" : "", cpu->id, cpu->m_name.c_str(), cpu->pc);
+	};
+
 	if (jit)
 	{
 		while (LIKELY(!test(state) || !check_state()))
@@ -539,6 +638,38 @@ void SPUThread::cpu_task()
 
 	// LS pointer
 	const auto base = vm::_ptr<const u8>(offset);
+
+	if (!interp_blocks.empty())
+	{
+		while (true)
+		{
+			// Wrap around the end of LS
+			pc &= 0x3fffc;
+
+			if (UNLIKELY(test(state)))
+			{
+				if (check_state()) return;
+
+				// Decode single instruction (may be step)
+				const u32 op = *reinterpret_cast<const be_t<u32>*>(base + pc);
+				if (table[spu_decode(op)](*this, {op})) { pc += 4; }
+				continue;
+			}
+
+			auto& block = interp_blocks[pc / 4];
+
+			// Verify the block against current LS contents (code may be overwritten by DMA or stores)
+			if (UNLIKELY(!block || std::memcmp(block->data.data(), base + pc, block->data.size() * 4)))
+			{
+				block = spu_build_block(table, base, pc);
+			}
+
+			for (auto ptr = block->ops.data(); LIKELY(ptr->func(*this, ptr->op)); ptr++)
+			{
+				pc += 4;
+			}
+		}
+	}
 	const auto bswap4 = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
 
 	v128 _op;
@@ -642,11 +773,23 @@ SPUThread::SPUThread(const std::string& name, u32 index, lv2_spu_group* group)
 		jit = spu_recompiler_base::make_llvm_recompiler();
 	}
 
+	if ((g_cfg.core.spu_decoder == spu_decoder_type::fast || g_cfg.core.spu_decoder == spu_decoder_type::precise) && g_cfg.core.spu_block_interpreter)
+	{
+		// Initialize block table
+		interp_blocks.resize(0x10000);
+	}
+
 	if (g_cfg.core.spu_decoder != spu_decoder_type::fast && g_cfg.core.spu_decoder != spu_decoder_type::precise)
 	{
 		// Initialize lookup table
 		jit_dispatcher.fill(&spu_recompiler_base::dispatch);
 
+		if (g_cfg.core.spu_async_compile && g_cfg.core.spu_shared_runtime)
+		{
+			// Enable asynchronous compilation
+			jit_queued.reset(new spu_function_t[0x10000]{});
+		}
+
 		if (g_cfg.core.spu_block_size != spu_block_size_type::safe)
 		{
 			// Initialize stack mirror
@@ -1157,6 +1300,8 @@ u32 SPUThread::get_mfc_completed()
 
 bool SPUThread::process_mfc_cmd(spu_mfc_cmd args)
 {
+	prof::scoped_zone zone("MFC", args.cmd);
+
 	// Stall infinitely if MFC queue is full
 	while (UNLIKELY(mfc_size >= 16))
 	{
@@ -1183,22 +1328,34 @@ bool SPUThread::process_mfc_cmd(spu_mfc_cmd args)
 			ch_event_stat |= SPU_EVENT_LR;
 		}
 
-		raddr = addr;
+		// Detect polling: the same line is read again while nobody has modified it
+		if (raddr == addr && vm::reservation_acquire(addr, 128) == rtime && rdata == data)
+		{
+			rpolls++;
+		}
+		else
+		{
+			rpolls = 0;
+		}
 
-		const bool is_polling = false; // TODO
+		raddr = addr;
 
-		if (is_polling)
+		if (rpolls >= 8 && g_cfg.core.spu_loop_detection)
 		{
-			rtime = vm::reservation_acquire(raddr, 128);
+			// Park once until the reservation is updated (PUTLLC, PUTLLUC, PPU conditional store) or 100 us pass,
+			// the loop may also be left for other events (mailbox, signal, decrementer), so the next GETLLAR parks again
+			std::shared_lock<notifier> pseudo_lock(vm::reservation_notifier(raddr, 128), std::try_to_lock);
 
-			while (rdata == data && vm::reservation_acquire(raddr, 128) == rtime)
+			if (!test(state) && rdata == data && vm::reservation_acquire(raddr, 128) == rtime)
 			{
-				if (test(state, cpu_flag::stop))
+				if (pseudo_lock)
 				{
-					break;
+					pseudo_lock.mutex()->wait(100);
+				}
+				else
+				{
+					thread_ctrl::wait_for(100);
 				}
-
-				thread_ctrl::wait_for(100);
 			}
 		}
 
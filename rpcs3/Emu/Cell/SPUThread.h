@@ -539,6 +539,7 @@ public:
 	u64 rtime = 0;
 	std::array<u128, 8> rdata{};
 	u32 raddr = 0;
+	u32 rpolls = 0; // Number of repeated GETLLAR with unchanged reservation
 
 	u32 srr0;
 	u32 ch_tag_upd;
@@ -588,6 +589,10 @@ public:
 
 	std::array<spu_function_t, 0x10000> jit_dispatcher; // Dispatch table for indirect calls
 
+	std::unique_ptr<spu_function_t[]> jit_queued; // Runtime dispatcher value at the time the block was queued for asynchronous compilation
+
+	std::vector<std::unique_ptr<struct spu_block>> interp_blocks; // Pre-decoded blocks by LS address (block interpreter)
+
 	std::array<v128, 0x4000> stack_mirror; // Return address information
 
 	void push_snr(u32 number, u32 value);
@@ -4,6 +4,7 @@
 #include "Emu/Cell/PPUFunction.h"
 #include "Emu/Cell/ErrorCodes.h"
 #include "Emu/Cell/MFC.h"
+#include "Utilities/profiler.h"
 #include "sys_sync.h"
 #include "sys_lwmutex.h"
 #include "sys_lwcond.h"
@@ -976,6 +977,7 @@ extern void ppu_execute_syscall(ppu_thread& ppu, u64 code)
 	{
 		if (auto func = g_ppu_syscall_table[code])
 		{
+			prof::scoped_zone zone("syscall", code);
 			func(ppu);
 			LOG_TRACE(PPU, "Syscall '%s' (%llu) finished, r3=0x%llx", ppu_syscall_code(code), code, ppu.gpr[3]);
 			return;
@@ -1145,6 +1147,8 @@ void lv2_obj::cleanup()
 	g_ppu.clear();
 	g_pending.clear();
 	g_waiting.clear();
+
+	lv2_sync_stats::dump();
 }
 
 void lv2_obj::schedule_all()
@@ -1187,3 +1191,146 @@ void lv2_obj::schedule_all()
 		}
 	}
 }
+
+// Statistics of all profiled objects (including destroyed)
+static shared_mutex s_sync_stats_mutex;
+static std::vector<std::shared_ptr<lv2_sync_stats>> s_sync_stats;
+
+lv2_sync_stats::lv2_sync_stats(const char* type, u64 name, u32 creator)
+	: type(type)
+	, name(name)
+	, creator(creator)
+{
+	for (auto& count : wait_hist)
+	{
+		count.store(0);
+	}
+}
+
+void lv2_sync_stats::acquired(u64 wait_start)
+{
+	acquires++;
+
+	if (!wait_start)
+	{
+		return;
+	}
+
+	const u64 wait = get_system_time() - wait_start;
+
+	contended++;
+	wait_time += wait;
+	wait_hist[std::min<u64>(64 - cntlz64(wait), wait_hist.size() - 1)]++;
+
+	max_wait.atomic_op([&](u64& value)
+	{
+		value = std::max(value, wait);
+	});
+}
+
+std::shared_ptr<lv2_sync_stats> lv2_sync_stats::make(const char* type, u64 name)
+{
+	if (!g_cfg.misc.profile_sync_objects)
+	{
+		return nullptr;
+	}
+
+	u32 creator = 0;
+
+	if (const auto cpu = get_current_cpu_thread())
+	{
+		if (cpu->id_type() == 1)
+		{
+			creator = static_cast<u32>(static_cast<ppu_thread*>(cpu)->lr);
+		}
+	}
+
+	auto result = std::make_shared<lv2_sync_stats>(type, name, creator);
+
+	writer_lock lock(s_sync_stats_mutex);
+	s_sync_stats.emplace_back(result);
+	return result;
+}
+
+std::vector<std::string> lv2_sync_stats::report()
+{
+	// Wait time snapshot (sort key, the counters keep changing while the game runs)
+	std::vector<std::pair<u64, std::shared_ptr<lv2_sync_stats>>> list;
+	{
+		reader_lock lock(s_sync_stats_mutex);
+
+		for (const auto& stats : s_sync_stats)
+		{
+			list.emplace_back(stats->wait_time.load(), stats);
+		}
+	}
+
+	std::stable_sort(list.begin(), list.end(), [](const auto& a, const auto& b)
+	{
+		return a.first > b.first;
+	});
+
+	std::vector<std::string> result;
+
+	for (const auto& pair : list)
+	{
+		const auto& stats = pair.second;
+		const u64 acquires = stats->acquires;
+
+		if (!acquires)
+		{
+			continue;
+		}
+
+		// Name is up to 7 characters
+		char name[8]{};
+		std::memcpy(name, &stats->name, 7);
+
+		const u64 contended = stats->contended;
+		const u64 wait_time = pair.first;
+
+		std::string line = fmt::format("%s 0x%08x \"%s\" (created at 0x%x): Acquires = %llu, Contended = %llu (%.1f%%), Wait = %llu us (max %llu us, avg %llu us)",
+			stats->type, stats->id.load(), name, stats->creator, acquires, contended, contended * 100. / acquires, wait_time, stats->max_wait.load(), contended ? wait_time / contended : 0);
+
+		if (const u64 hold_time = stats->hold_time)
+		{
+			fmt::append(line, ", Hold = %llu us", hold_time);
+		}
+
+		if (contended)
+		{
+			line += ", Wait histogram:";
+
+			for (std::size_t i = 0; i < stats->wait_hist.size(); i++)
+			{
+				if (const u64 count = stats->wait_hist[i])
+				{
+					if (i + 1 == stats->wait_hist.size())
+					{
+						// Overflow bucket
+						fmt::append(line, " >=%llu us: %llu;", 1ull << (i - 1), count);
+					}
+					else
+					{
+						fmt::append(line, " <%llu us: %llu;", 1ull << i, count);
+					}
+				}
+			}
+		}
+
+		result.emplace_back(std::move(line));
+	}
+
+	return result;
+}
+
+void lv2_sync_stats::dump()
+{
+	for (const auto& line : report())
+	{
+		LOG_NOTICE(GENERAL, "Sync profile: %s", line);
+	}
+
+	writer_lock lock(s_sync_stats_mutex);
+	s_sync_stats.clear();
+}
@@ -42,6 +42,7 @@ error_code sys_cond_create(vm::ptr<u32> cond_id, u32 mutex_id, vm::ptr<sys_cond_
 	}
 
 	*cond_id = idm::last_id();
+	lv2_sync_stats::set_id<lv2_cond>(idm::last_id());
 	return CELL_OK;
 }
 
@@ -198,6 +199,9 @@ error_code sys_cond_wait(ppu_thread& ppu, u32 cond_id, u64 timeout)
 {
 	sys_cond.trace("sys_cond_wait(cond_id=0x%x, timeout=%lld)", cond_id, timeout);
 
+	// Sleep start time (ppu.start_time is reset on wakeup)
+	u64 wait_start = 0;
+
 	const auto cond = idm::get<lv2_obj, lv2_cond>(cond_id, [&](lv2_cond& cond)
 	{
 		// Add a "promise" to add a waiter
@@ -225,10 +229,12 @@ error_code sys_cond_wait(ppu_thread& ppu, u32 cond_id, u64 timeout)
 
 		// Register waiter
 		cond->sq.emplace_back(&ppu);
+		wait_start = get_system_time();
 		cond->sleep(ppu, timeout);
 
 		// Unlock the mutex
 		cond->mutex->lock_count = 0;
+		cond->mutex->profile_unlock(ppu.id);
 
 		if (auto cpu = cond->mutex->reown<ppu_thread>())
 		{
@@ -278,7 +284,13 @@ error_code sys_cond_wait(ppu_thread& ppu, u32 cond_id, u64 timeout)
 	// Verify ownership
 	verify(HERE), cond->mutex->owner >> 1 == ppu.id;
 
+	if (cond->stats && ppu.gpr[3] == CELL_OK)
+	{
+		cond->stats->acquired(wait_start);
+	}
+
 	// Restore the recursive value
+	cond->mutex->profile_lock();
 	cond->mutex->lock_count = cond.ret;
 
 	return not_an_error(ppu.gpr[3]);
@@ -30,12 +30,15 @@ struct lv2_cond final : lv2_obj
 	atomic_t<u32> waiters{0};
 	std::deque<cpu_thread*> sq;
 
+	const std::shared_ptr<lv2_sync_stats> stats; // Contention statistics (if enabled)
+
 	lv2_cond(u32 shared, s32 flags, u64 key, u64 name, std::shared_ptr<lv2_mutex> mutex)
 		: shared(shared)
 		, key(key)
 		, flags(flags)
 		, name(name)
 		, mutex(std::move(mutex))
+		, stats(lv2_sync_stats::make("Cond", name))
 	{
 		this->mutex->cond_count++;
 	}
@@ -107,6 +107,7 @@ error_code sys_event_queue_create(vm::ptr<u32> equeue_id, vm::ptr<sys_event_queu
 		if (const u32 _id = idm::import_existing<lv2_obj, lv2_event_queue>(std::move(queue)))
 		{
 			*equeue_id = _id;
+			lv2_sync_stats::set_id<lv2_event_queue>(_id);
 			return CELL_OK;
 		}
 
@@ -119,6 +120,7 @@ error_code sys_event_queue_create(vm::ptr<u32> equeue_id, vm::ptr<sys_event_queu
 		if (const u32 _id = idm::import_existing<lv2_obj, lv2_event_queue>(queue))
 		{
 			*equeue_id = _id;
+			lv2_sync_stats::set_id<lv2_event_queue>(_id);
 			return std::move(queue);
 		}
 
@@ -230,6 +232,9 @@ error_code sys_event_queue_receive(ppu_thread& ppu, u32 equeue_id, vm::ptr<sys_e
 
 	ppu.gpr[3] = CELL_OK;
 
+	// Sleep start time (ppu.start_time is reset on wakeup)
+	u64 wait_start = 0;
+
 	const auto queue = idm::get<lv2_obj, lv2_event_queue>(equeue_id, [&](lv2_event_queue& queue) -> CellError
 	{
 		if (queue.type != SYS_PPU_QUEUE)
@@ -242,6 +247,7 @@ error_code sys_event_queue_receive(ppu_thread& ppu, u32 equeue_id, vm::ptr<sys_e
 		if (queue.events.empty())
 		{
 			queue.sq.emplace_back(&ppu);
+			wait_start = get_system_time();
 			queue.sleep(ppu, timeout);
 			return CELL_EBUSY;
 		}
@@ -265,6 +271,11 @@ error_code sys_event_queue_receive(ppu_thread& ppu, u32 equeue_id, vm::ptr<sys_e
 	}
 	else
 	{
+		if (queue->stats)
+		{
+			queue->stats->acquired();
+		}
+
 		return CELL_OK;
 	}
 
@@ -297,6 +308,11 @@ error_code sys_event_queue_receive(ppu_thread& ppu, u32 equeue_id, vm::ptr<sys_e
 		}
 	}
 
+	if (queue->stats && ppu.gpr[3] == CELL_OK)
+	{
+		queue->stats->acquired(wait_start);
+	}
+
 	return not_an_error(ppu.gpr[3]);
 }
 
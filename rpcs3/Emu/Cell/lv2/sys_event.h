@@ -87,12 +87,15 @@ struct lv2_event_queue final : public lv2_obj
 	std::deque<lv2_event> events;
 	std::deque<cpu_thread*> sq;
 
+	const std::shared_ptr<lv2_sync_stats> stats; // Contention statistics (if enabled)
+
 	lv2_event_queue(u32 protocol, s32 type, u64 name, u64 ipc_key, s32 size)
 		: protocol(protocol)
 		, type(type)
 		, name(name)
 		, key(ipc_key)
 		, size(size)
+		, stats(lv2_sync_stats::make("Event Queue", name))
 	{
 	}
 
@@ -8,6 +8,7 @@
 #include "Emu/VFS.h"
 #include "Emu/IdManager.h"
 #include "Utilities/StrUtil.h"
+#include "Utilities/profiler.h"
 
 
 
@@ -192,6 +193,8 @@ error_code sys_fs_open(vm::cptr<char> path, s32 flags, vm::ptr<u32> fd, s32 mode
 {
 	sys_fs.warning("sys_fs_open(path=%s, flags=%#o, fd=*0x%x, mode=%#o, arg=*0x%x, size=0x%llx)", path, flags, fd, mode, arg, size);
 
+	prof::scoped_zone zone("sys_fs_open");
+
 	if (!path)
 		return CELL_EFAULT;
 
@@ -383,6 +386,8 @@ error_code sys_fs_read(u32 fd, vm::ptr<void> buf, u64 nbytes, vm::ptr<u64> nread
 {
 	sys_fs.trace("sys_fs_read(fd=%d, buf=*0x%x, nbytes=0x%llx, nread=*0x%x)", fd, buf, nbytes, nread);
 
+	prof::scoped_zone zone("sys_fs_read", nbytes);
+
 	if (!buf)
 	{
 		return CELL_EFAULT;
@@ -406,6 +411,8 @@ error_code sys_fs_write(u32 fd, vm::cptr<void> buf, u64 nbytes, vm::ptr<u64> nwr
 {
 	sys_fs.trace("sys_fs_write(fd=%d, buf=*0x%x, nbytes=0x%llx, nwrite=*0x%x)", fd, buf, nbytes, nwrite);
 
+	prof::scoped_zone zone("sys_fs_write", nbytes);
+
 	const auto file = idm::get<lv2_fs_object, lv2_file>(fd);
 
 	if (!file || !(file->flags & CELL_FS_O_ACCMODE))
@@ -553,6 +560,8 @@ error_code sys_fs_stat(vm::cptr<char> path, vm::ptr<CellFsStat> sb)
 {
 	sys_fs.warning("sys_fs_stat(path=%s, sb=*0x%x)", path, sb);
 
+	prof::scoped_zone zone("sys_fs_stat");
+
 	if (!path)
 		return CELL_EFAULT;
 
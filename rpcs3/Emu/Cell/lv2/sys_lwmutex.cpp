@@ -34,6 +34,7 @@ error_code _sys_lwmutex_create(vm::ptr<u32> lwmutex_id, u32 protocol, vm::ptr<sy
 	if (const u32 id = idm::make<lv2_obj, lv2_lwmutex>(protocol, control, name))
 	{
 		*lwmutex_id = id;
+		lv2_sync_stats::set_id<lv2_lwmutex>(id);
 		return CELL_OK;
 	}
 
@@ -73,6 +74,9 @@ error_code _sys_lwmutex_lock(ppu_thread& ppu, u32 lwmutex_id, u64 timeout)
 {
 	sys_lwmutex.trace("_sys_lwmutex_lock(lwmutex_id=0x%x, timeout=0x%llx)", lwmutex_id, timeout);
 
+	// Sleep start time (ppu.start_time is reset on wakeup)
+	u64 wait_start = 0;
+
 	const auto mutex = idm::get<lv2_obj, lv2_lwmutex>(lwmutex_id, [&](lv2_lwmutex& mutex)
 	{
 		if (u32 value = mutex.signaled)
@@ -94,6 +98,7 @@ error_code _sys_lwmutex_lock(ppu_thread& ppu, u32 lwmutex_id, u64 timeout)
 		}
 
 		mutex.sq.emplace_back(&ppu);
+		wait_start = get_system_time();
 		mutex.sleep(ppu, timeout);
 		return false;
 	});
@@ -105,6 +110,11 @@ error_code _sys_lwmutex_lock(ppu_thread& ppu, u32 lwmutex_id, u64 timeout)
 
 	if (mutex.ret)
 	{
+		if (mutex->stats)
+		{
+			mutex->stats->acquired();
+		}
+
 		return CELL_OK;
 	}
 
@@ -138,6 +148,11 @@ error_code _sys_lwmutex_lock(ppu_thread& ppu, u32 lwmutex_id, u64 timeout)
 		}
 	}
 
+	if (mutex->stats && ppu.gpr[3] == CELL_OK)
+	{
+		mutex->stats->acquired(wait_start);
+	}
+
 	return not_an_error(ppu.gpr[3]);
 }
 
@@ -61,10 +61,14 @@ struct lv2_lwmutex final : lv2_obj
 	atomic_t<u32> signaled{0};
 	std::deque<cpu_thread*> sq;
 
+	lv2_spin_policy spin; // Contended wait statistics for adaptive spinning
+	const std::shared_ptr<lv2_sync_stats> stats; // Contention statistics (if enabled)
+
 	lv2_lwmutex(u32 protocol, vm::ptr<sys_lwmutex_t> control, u64 name)
 		: protocol(protocol)
 		, control(control)
 		, name(name)
+		, stats(lv2_sync_stats::make("LWMutex", name))
 	{
 	}
 };
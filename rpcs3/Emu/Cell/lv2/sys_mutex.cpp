@@ -71,6 +71,7 @@ error_code sys_mutex_create(vm::ptr<u32> mutex_id, vm::ptr<sys_mutex_attribute_t
 	}
 
 	*mutex_id = idm::last_id();
+	lv2_sync_stats::set_id<lv2_mutex>(idm::last_id());
 	return CELL_OK;
 }
 
@@ -110,6 +111,30 @@ error_code sys_mutex_lock(ppu_thread& ppu, u32 mutex_id, u64 timeout)
 {
 	sys_mutex.trace("sys_mutex_lock(mutex_id=0x%x, timeout=0x%llx)", mutex_id, timeout);
 
+	// Spin without holding the IDM lock
+	if (const auto mutex = idm::get<lv2_obj, lv2_mutex>(mutex_id))
+	{
+		CellError result = mutex->try_lock(ppu.id);
+
+		if (result != CELL_EBUSY || mutex->spin.wait([&] { return (result = mutex->try_lock(ppu.id)) != CELL_EBUSY; }))
+		{
+			if (result)
+			{
+				return result;
+			}
+
+			mutex->profile_lock();
+			return CELL_OK;
+		}
+	}
+	else
+	{
+		return CELL_ESRCH;
+	}
+
+	// Sleep start time (ppu.start_time is reset on wakeup)
+	u64 wait_start = 0;
+
 	const auto mutex = idm::get<lv2_obj, lv2_mutex>(mutex_id, [&](lv2_mutex& mutex)
 	{
 		CellError result = mutex.try_lock(ppu.id);
@@ -124,6 +149,7 @@ error_code sys_mutex_lock(ppu_thread& ppu, u32 mutex_id, u64 timeout)
 			}
 			else
 			{
+				wait_start = get_system_time();
 				mutex.sleep(ppu, timeout);
 			}
 		}
@@ -145,6 +171,7 @@ error_code sys_mutex_lock(ppu_thread& ppu, u32 mutex_id, u64 timeout)
 	}
 	else
 	{
+		mutex->profile_lock();
 		return CELL_OK;
 	}
 
@@ -178,6 +205,11 @@ error_code sys_mutex_lock(ppu_thread& ppu, u32 mutex_id, u64 timeout)
 		}
 	}
 
+	if (ppu.gpr[3] == CELL_OK)
+	{
+		mutex->profile_lock(wait_start);
+	}
+
 	return not_an_error(ppu.gpr[3]);
 }
 
@@ -205,6 +237,7 @@ error_code sys_mutex_trylock(ppu_thread& ppu, u32 mutex_id)
 		return mutex.ret;
 	}
 
+	mutex->profile_lock();
 	return CELL_OK;
 }
 
@@ -214,6 +247,7 @@ error_code sys_mutex_unlock(ppu_thread& ppu, u32 mutex_id)
 
 	const auto mutex = idm::check<lv2_obj, lv2_mutex>(mutex_id, [&](lv2_mutex& mutex)
 	{
+		mutex.profile_unlock(ppu.id);
 		return mutex.try_unlock(ppu.id);
 	});
 
@@ -37,6 +37,10 @@ struct lv2_mutex final : lv2_obj
 	atomic_t<u32> cond_count{0}; // Condition Variables
 	std::deque<cpu_thread*> sq;
 
+	lv2_spin_policy spin; // Contended wait statistics for adaptive spinning
+	const std::shared_ptr<lv2_sync_stats> stats; // Contention statistics (if enabled)
+	u64 lock_time = 0; // Owner lock timestamp (only if stats are enabled)
+
 	lv2_mutex(u32 protocol, u32 recursive, u32 shared, u32 adaptive, u64 key, s32 flags, u64 name)
 		: protocol(protocol)
 		, recursive(recursive)
@@ -45,6 +49,7 @@ struct lv2_mutex final : lv2_obj
 		, key(key)
 		, flags(flags)
 		, name(name)
+		, stats(lv2_sync_stats::make("Mutex", name))
 	{
 	}
 
@@ -127,6 +132,29 @@ struct lv2_mutex final : lv2_obj
 		return CELL_EBUSY;
 	}
 
+	// Update statistics after successful lock (wait_start is 0 if the thread didn't sleep)
+	void profile_lock(u64 wait_start = 0)
+	{
+		if (stats)
+		{
+			stats->acquired(wait_start);
+
+			if (!lock_count)
+			{
+				lock_time = get_system_time();
+			}
+		}
+	}
+
+	// Update statistics before unlocking
+	void profile_unlock(u32 id)
+	{
+		if (stats && owner >> 1 == id && !lock_count)
+		{
+			stats->released(get_system_time() - lock_time);
+		}
+	}
+
 	template <typename T>
 	T* reown()
 	{
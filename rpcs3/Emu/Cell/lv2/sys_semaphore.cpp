@@ -51,6 +51,7 @@ error_code sys_semaphore_create(vm::ptr<u32> sem_id, vm::ptr<sys_semaphore_attri
 	}
 
 	*sem_id = idm::last_id();
+	lv2_sync_stats::set_id<lv2_sema>(idm::last_id());
 	return CELL_OK;
 }
 
@@ -85,23 +86,42 @@ error_code sys_semaphore_wait(ppu_thread& ppu, u32 sem_id, u64 timeout)
 {
 	sys_semaphore.trace("sys_semaphore_wait(sem_id=0x%x, timeout=0x%llx)", sem_id, timeout);
 
-	const auto sem = idm::get<lv2_obj, lv2_sema>(sem_id, [&](lv2_sema& sema)
+	// Spin without holding the IDM lock
+	if (const auto sem = idm::get<lv2_obj, lv2_sema>(sem_id))
 	{
-		const s32 val = sema.val;
+		auto try_wait = [&]()
+		{
+			const s32 val = sem->val;
 
-		if (val > 0)
+			return val > 0 && sem->val.compare_and_swap_test(val, val - 1);
+		};
+
+		if (try_wait() || sem->spin.wait(try_wait))
 		{
-			if (sema.val.compare_and_swap_test(val, val - 1))
+			if (sem->stats)
 			{
-				return true;
+				sem->stats->acquired();
 			}
+
+			return CELL_OK;
 		}
+	}
+	else
+	{
+		return CELL_ESRCH;
+	}
 
+	// Sleep start time (ppu.start_time is reset on wakeup)
+	u64 wait_start = 0;
+
+	const auto sem = idm::get<lv2_obj, lv2_sema>(sem_id, [&](lv2_sema& sema)
+	{
 		semaphore_lock lock(sema.mutex);
 
 		if (sema.val-- <= 0)
 		{
 			sema.sq.emplace_back(&ppu);
+			wait_start = get_system_time();
 			sema.sleep(ppu, timeout);
 			return false;
 		}
@@ -116,6 +136,11 @@ error_code sys_semaphore_wait(ppu_thread& ppu, u32 sem_id, u64 timeout)
 
 	if (sem.ret)
 	{
+		if (sem->stats)
+		{
+			sem->stats->acquired();
+		}
+
 		return CELL_OK;
 	}
 
@@ -157,6 +182,11 @@ error_code sys_semaphore_wait(ppu_thread& ppu, u32 sem_id, u64 timeout)
 		}
 	}
 
+	if (sem->stats && ppu.gpr[3] == CELL_OK)
+	{
+		sem->stats->acquired(wait_start);
+	}
+
 	return not_an_error(ppu.gpr[3]);
 }
 
@@ -189,6 +219,11 @@ error_code sys_semaphore_trywait(u32 sem_id)
 		return not_an_error(CELL_EBUSY);
 	}
 
+	if (sem->stats)
+	{
+		sem->stats->acquired();
+	}
+
 	return CELL_OK;
 }
 
@@ -32,6 +32,9 @@ struct lv2_sema final : lv2_obj
 	atomic_t<s32> val;
 	std::deque<cpu_thread*> sq;
 
+	lv2_spin_policy spin; // Contended wait statistics for adaptive spinning
+	const std::shared_ptr<lv2_sync_stats> stats; // Contention statistics (if enabled)
+
 	lv2_sema(u32 protocol, u32 shared, u64 key, s32 flags, u64 name, s32 max, s32 value)
 		: protocol(protocol)
 		, shared(shared)
@@ -40,6 +43,7 @@ struct lv2_sema final : lv2_obj
 		, name(name)
 		, max(max)
 		, val(value)
+		, stats(lv2_sync_stats::make("Semaphore", name))
 	{
 	}
 };
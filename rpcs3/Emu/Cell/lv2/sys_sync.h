@@ -11,6 +11,9 @@
 #include "Emu/IPC.h"
 
 #include <deque>
+#include <thread>
+
+extern u64 get_system_time();
 
 // attr_protocol (waiting scheduling policy)
 enum
@@ -55,6 +58,81 @@ enum
 	SYS_SYNC_ATTR_ADAPTIVE_MASK  = 0xf000,
 };
 
+// Adaptive waiting: the moving average of contended acquire time decides whether to spin, yield or sleep immediately
+struct lv2_spin_policy
+{
+	static constexpr u32 spin_min = 2000; // Minimal spin time (TSC ticks)
+	static constexpr u32 spin_max = 50000; // Don't spin if the average is above
+	static constexpr u32 yield_max = 1000000; // Don't yield if the average is above
+
+	atomic_t<u32> average{0}; // TSC ticks (saturated)
+
+	// Add spinning time sample (sleep time isn't sampled because it doesn't depend on the owner)
+	void update(u64 ticks)
+	{
+		const u32 sample = static_cast<u32>(std::min<u64>(ticks, UINT32_MAX));
+
+		average.atomic_op([&](u32& value)
+		{
+			value = value - value / 8 + sample / 8;
+		});
+	}
+
+	// Wait for the condition if it's likely to become true soon (returns false if the thread should sleep)
+	template <typename F>
+	bool wait(F&& test)
+	{
+		const u32 expected = average;
+		const u64 start = __rdtsc();
+
+		if (expected <= spin_max)
+		{
+			// Spin for twice the average time
+			const u64 limit = std::max<u64>(expected * 2, spin_min);
+
+			do
+			{
+				busy_wait(300);
+
+				if (test())
+				{
+					update(__rdtsc() - start);
+					return true;
+				}
+			}
+			while (__rdtsc() - start < limit);
+
+			// Assume the owner needs longer than the limit
+			update(limit * 2);
+		}
+		else if (expected <= yield_max)
+		{
+			for (u32 i = 0; i < 4; i++)
+			{
+				std::this_thread::yield();
+
+				if (test())
+				{
+					update(__rdtsc() - start);
+					return true;
+				}
+			}
+
+			update(u64{yield_max} * 2);
+		}
+		else
+		{
+			// Decay the average on every sleep, so spinning is retried eventually
+			average.atomic_op([](u32& value)
+			{
+				value -= value / 32;
+			});
+		}
+
+		return false;
+	}
+};
+
 // Base class for some kernel objects (shared set of 8192 objects).
 struct lv2_obj
 {
@@ -228,3 +306,51 @@ private:
 
 	static void schedule_all();
 };
+
+// Contention statistics of a synchronization object (collected if "Profile sync objects" is enabled)
+struct lv2_sync_stats
+{
+	const char* const type;
+	atomic_t<u32> id{0}; // Set once after the object is published in idm
+	const u64 name;
+	const u32 creator; // Return address of the creating syscall
+
+	atomic_t<u64> acquires{0}; // Successful locks, waits or receives
+	atomic_t<u64> contended{0}; // Acquires which had to sleep
+	atomic_t<u64> wait_time{0}; // Total sleep time (us)
+	atomic_t<u64> max_wait{0};
+	atomic_t<u64> hold_time{0}; // Total owner hold time (us), mutexes only
+	std::array<atomic_t<u64>, 20> wait_hist; // Sleep time histogram (bucket N: less than 2^N us, the last one: 2^(N-1) us or more)
+
+	lv2_sync_stats(const char* type, u64 name, u32 creator);
+
+	// Record successful acquire (wait_start is the sleep start time, 0 if the thread didn't sleep)
+	void acquired(u64 wait_start = 0);
+
+	void released(u64 hold)
+	{
+		hold_time += hold;
+	}
+
+	// Set the ID of the created object (statistics are created by the object constructor)
+	template <typename T>
+	static void set_id(u32 id)
+	{
+		if (const auto obj = idm::get_unlocked<lv2_obj, T>(id))
+		{
+			if (obj->stats)
+			{
+				obj->stats->id.compare_and_swap(0, id);
+			}
+		}
+	}
+
+	// Create statistics for the new object (only if profiling is enabled)
+	static std::shared_ptr<lv2_sync_stats> make(const char* type, u64 name);
+
+	// Get report lines sorted by total sleep time
+	static std::vector<std::string> report();
+
+	// Write the report to the log and forget all objects
+	static void dump();
+};
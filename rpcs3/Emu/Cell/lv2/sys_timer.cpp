@@ -17,61 +17,100 @@ logs::channel sys_timer("sys_timer");
 
 extern u64 get_system_time();
 
-void lv2_timer::on_task()
+void lv2_timer_thread::on_task()
 {
-	while (!Emu.IsStopped())
+	while (fxm::check<lv2_timer_thread>() && !Emu.IsStopped())
 	{
-		const u32 _state = state;
-
-		if (_state == SYS_TIMER_STATE_RUN)
+		entry next{};
+		u64 wait_time = 10000;
 		{
-			const u64 _now = get_system_time();
-			const u64 next = expire;
+			semaphore_lock lock(m_mutex);
 
-			if (_now >= next)
+			if (!m_queue.empty())
 			{
-				semaphore_lock lock(mutex);
+				const u64 _now = get_system_time();
 
-				if (const auto queue = port.lock())
+				if (m_queue.front().expire <= _now)
 				{
-					queue->send(source, data1, data2, next);
-
-					if (period)
-					{
-						// Set next expiration time and check again (HACK)
-						expire += period;
-						continue;
-					}
+					std::pop_heap(m_queue.begin(), m_queue.end());
+					next = m_queue.back();
+					m_queue.pop_back();
+				}
+				else
+				{
+					wait_time = m_queue.front().expire - _now;
 				}
-
-				// Stop: oneshot or the event port was disconnected (TODO: is it correct?)
-				state = SYS_TIMER_STATE_STOP;
-				continue;
 			}
-
-			// TODO: use single global dedicated thread for busy waiting, no timer threads
-			lv2_obj::sleep_timeout(*this, next - _now);
-			thread_ctrl::wait_for(next - _now);
 		}
-		else if (_state == SYS_TIMER_STATE_STOP)
+
+		if (!next.timer_id)
 		{
-			thread_ctrl::wait_for(10000);
+			thread_ctrl::wait_for(wait_time);
+			continue;
 		}
-		else
+
+		idm::check<lv2_obj, lv2_timer>(next.timer_id, [&](lv2_timer& timer)
 		{
-			break;
-		}
+			semaphore_lock lock(timer.mutex);
+
+			if (timer.state != SYS_TIMER_STATE_RUN || timer.expire != next.expire)
+			{
+				// Stopped or restarted
+				return;
+			}
+
+			const u64 late = get_system_time() - next.expire;
+			m_fired++;
+			m_late_total += late;
+			m_late_max = std::max(m_late_max, late);
+
+			if (const auto queue = timer.port.lock())
+			{
+				queue->send(timer.source, timer.data1, timer.data2, next.expire);
+
+				if (timer.period)
+				{
+					// Advance from the previous expiration time to avoid drift
+					timer.expire += timer.period;
+					schedule(next.timer_id, timer.expire);
+					return;
+				}
+			}
+
+			// Stop: oneshot or the event port was disconnected (TODO: is it correct?)
+			timer.state = SYS_TIMER_STATE_STOP;
+		});
+	}
+}
+
+void lv2_timer_thread::on_exit()
+{
+	if (m_fired)
+	{
+		sys_timer.notice("Timer thread: %llu events, average latency %llu us, max latency %llu us", m_fired, m_late_total / m_fired, m_late_max);
 	}
 }
 
-void lv2_timer::on_stop()
+void lv2_timer_thread::on_stop()
 {
-	// Signal thread using invalid state
-	state = -1;
 	notify();
 	join();
 }
 
+void lv2_timer_thread::schedule(u32 timer_id, u64 expire)
+{
+	semaphore_lock lock(m_mutex);
+
+	m_queue.push_back({expire, timer_id});
+	std::push_heap(m_queue.begin(), m_queue.end());
+
+	if (m_queue.front().timer_id == timer_id && m_queue.front().expire == expire)
+	{
+		// Wake up to recalculate the wait time
+		notify();
+	}
+}
+
 error_code sys_timer_create(vm::ptr<u32> timer_id)
 {
 	sys_timer.warning("sys_timer_create(timer_id=*0x%x)", timer_id);
@@ -153,6 +192,8 @@ error_code _sys_timer_start(u32 timer_id, u64 base_time, u64 period)
 		return CELL_EINVAL;
 	}
 
+	const auto thread = fxm::get_always<lv2_timer_thread>();
+
 	const auto timer = idm::check<lv2_obj, lv2_timer>(timer_id, [&](lv2_timer& timer) -> CellError
 	{
 		semaphore_lock lock(timer.mutex);
@@ -171,7 +212,7 @@ error_code _sys_timer_start(u32 timer_id, u64 base_time, u64 period)
 		timer.expire = base_time ? base_time : start_time + period;
 		timer.period = period;
 		timer.state  = SYS_TIMER_STATE_RUN;
-		timer.notify();
+		thread->schedule(timer_id, timer.expire);
 		return {};
 	});
 
@@ -17,13 +17,10 @@ struct sys_timer_information_t
 	be_t<u32> pad;
 };
 
-struct lv2_timer final : public lv2_obj, public named_thread
+struct lv2_timer final : public lv2_obj
 {
 	static const u32 id_base = 0x11000000;
 
-	void on_task() override;
-	void on_stop() override;
-
 	semaphore<> mutex;
 	atomic_t<u32> state{SYS_TIMER_STATE_STOP};
 
@@ -36,6 +33,44 @@ struct lv2_timer final : public lv2_obj, public named_thread
 	atomic_t<u64> period{0}; // Period (oneshot if 0)
 };
 
+// Single thread firing events of all running timers
+class lv2_timer_thread final : public named_thread
+{
+	struct entry
+	{
+		u64 expire;
+		u32 timer_id;
+
+		// Reversed for min-heap
+		bool operator <(const entry& rhs) const
+		{
+			return expire > rhs.expire;
+		}
+	};
+
+	void on_task() override;
+
+	void on_exit() override;
+
+	std::string get_name() const override { return "Timer Thread"; }
+
+	semaphore<> m_mutex;
+
+	// Pending expirations (min-heap)
+	std::vector<entry> m_queue;
+
+	// Wakeup latency statistics (usec)
+	u64 m_fired = 0;
+	u64 m_late_total = 0;
+	u64 m_late_max = 0;
+
+public:
+	void on_stop() override;
+
+	// Register timer expiration (stale entries are ignored)
+	void schedule(u32 timer_id, u64 expire);
+};
+
 class ppu_thread;
 
 // Syscalls
@@ -7,31 +7,53 @@ thread_local DECLARE(idm::g_id);
 DECLARE(idm::g_map);
 DECLARE(fxm::g_vec);
 
+std::shared_ptr<void> id_manager::id_slot::release()
+{
+	state &= ~published;
+
+	// Wait for lock-free readers (they only copy the pointer)
+	while (state)
+	{
+		busy_wait(100);
+	}
+
+	return std::move(second);
+}
+
 id_manager::id_map::pointer idm::allocate_id(const id_manager::id_key& info, u32 base, u32 step, u32 count)
 {
 	// Base type id is stored in value
-	auto& vec = g_map[info.value()];
+	auto& map = g_map[info.value()];
 
-	// Preallocate memory
-	vec.reserve(count);
+	if (!map.slots)
+	{
+		// Allocate all slots (can't be reallocated later)
+		map.slots.reset(new id_manager::id_slot[count]);
+		map.count = count;
+	}
 
-	if (vec.size() < count)
+	count = std::min(count, map.count);
+
+	if (map.size < count)
 	{
 		// Try to emplace back
-		const u32 _next = base + step * ::size32(vec);
+		const u32 _next = base + step * map.size;
 
 		if (_next >= base && _next < base + step * count)
 		{
 			g_id = _next;
-			vec.emplace_back(id_manager::id_key(_next, info.type(), info.on_stop()), nullptr);
-			return &vec.back();
+
+			const auto ptr = &map.slots[map.size];
+			ptr->first = id_manager::id_key(_next, info.type(), info.on_stop());
+			map.size++;
+			return ptr;
 		}
 	}
 
 	// Check all IDs starting from "next id" (TODO)
 	for (u32 i = 0, next = base; i < count; i++, next += step)
 	{
-		const auto ptr = &vec[i];
+		const auto ptr = &map.slots[i];
 
 		// Look for free ID
 		if (!ptr->second)
@@ -49,26 +71,30 @@ id_manager::id_map::pointer idm::allocate_id(const id_manager::id_key& info, u32
 void idm::init()
 {
 	// Allocate
-	g_map.resize(id_manager::typeinfo::get_count());
+	g_map.reset(new id_manager::id_map[id_manager::typeinfo::get_count()]);
 	idm::clear();
 }
 
 void idm::clear()
 {
 	// Call recorded finalization functions for all IDs
-	for (auto& map : g_map)
+	for (u32 i = 0, count = id_manager::typeinfo::get_count(); i < count; i++)
 	{
-		for (auto& pair : map)
+		auto& map = g_map[i];
+
+		for (u32 j = 0, size = map.size; j < size; j++)
 		{
-			if (auto ptr = pair.second.get())
+			auto& slot = map.slots[j];
+
+			if (auto ptr = slot.second.get())
 			{
-				pair.first.on_stop()(ptr);
-				pair.second.reset();
-				pair.first = {};
+				slot.first.on_stop()(ptr);
+				slot.release().reset();
+				slot.first = {};
 			}
 		}
 
-		map.clear();
+		map.size = 0;
 	}
 }
 
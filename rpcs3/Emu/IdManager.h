@@ -171,7 +171,30 @@ namespace id_manager
 		}
 	};
 
-	using id_map = std::vector<std::pair<id_key, std::shared_ptr<void>>>;
+	// ID record
+	struct id_slot
+	{
+		id_key first;
+		std::shared_ptr<void> second;
+
+		// Lookup state: published flag and the number of lock-free readers copying the object
+		atomic_t<u32> state{0};
+
+		static constexpr u32 published = 0x80000000;
+
+		// Hide the object from lock-free readers and take it (writer lock required)
+		std::shared_ptr<void> release();
+	};
+
+	// All IDs of one type (slots are allocated once and never move, so lookups don't need the lock)
+	struct id_map
+	{
+		using pointer = id_slot*;
+
+		std::unique_ptr<id_slot[]> slots;
+		atomic_t<u32> size{0}; // Number of used slots
+		u32 count = 0; // Number of allocated slots
+	};
 }
 
 // Object manager for emulated process. Multiple objects of specified arbitrary type are given unique IDs.
@@ -181,7 +204,7 @@ class idm
 	static thread_local u32 g_id;
 
 	// Type Index -> ID -> Object. Use global since only one process is supported atm.
-	static std::vector<id_manager::id_map> g_map;
+	static std::unique_ptr<id_manager::id_map[]> g_map;
 
 	template <typename T>
 	static inline u32 get_type()
@@ -274,14 +297,14 @@ class idm
 
 		const u32 index = get_index<Type>(id);
 
-		auto& vec = g_map[get_type<T>()];
+		auto& map = g_map[get_type<T>()];
 
-		if (index >= vec.size() || index >= id_manager::id_traits<Type>::count)
+		if (index >= map.size || index >= id_manager::id_traits<Type>::count)
 		{
 			return nullptr;
 		}
 
-		auto& data = vec[index];
+		auto& data = map.slots[index];
 
 		if (data.second)
 		{
@@ -294,6 +317,48 @@ class idm
 		return nullptr;
 	}
 
+	// Find ID without locking, call func(record) while it can't be removed
+	template <typename T, typename Type, typename F>
+	static bool peek_id(u32 id, F&& func)
+	{
+		static_assert(id_manager::id_verify<T, Type>::value, "Invalid ID type combination");
+
+		const u32 index = get_index<Type>(id);
+
+		auto& map = g_map[get_type<T>()];
+
+		if (index >= map.size || index >= id_manager::id_traits<Type>::count)
+		{
+			return false;
+		}
+
+		auto& data = map.slots[index];
+
+		// Register as a reader if the object is published
+		const u32 state = data.state.fetch_op([](u32& value)
+		{
+			if (value & id_manager::id_slot::published)
+			{
+				value++;
+			}
+		});
+
+		if (!(state & id_manager::id_slot::published))
+		{
+			return false;
+		}
+
+		const bool found = std::is_same<T, Type>::value || data.first.type() == get_type<Type>();
+
+		if (found)
+		{
+			func(data);
+		}
+
+		data.state--;
+		return found;
+	}
+
 	// Allocate new ID and assign the object from the provider()
 	template <typename T, typename Type, typename F>
 	static id_manager::id_map::pointer create_id(F&& provider)
@@ -316,6 +381,7 @@ class idm
 
 			if (place->second)
 			{
+				place->state = id_manager::id_slot::published;
 				return place;
 			}
 		}
@@ -407,13 +473,18 @@ public:
 		return nullptr;
 	}
 
-	// Check the ID
+	// Check the ID (lock-free, the object isn't referenced)
 	template <typename T, typename Get = T>
 	static inline Get* check(u32 id)
 	{
-		reader_lock lock(id_manager::g_mutex);
+		Get* result = nullptr;
 
-		return check_unlocked<T, Get>(id);
+		peek_id<T, Get>(id, [&](id_manager::id_slot& data)
+		{
+			result = static_cast<Get*>(data.second.get());
+		});
+
+		return result;
 	}
 
 	// Check the ID, access object under shared lock
@@ -459,20 +530,18 @@ public:
 		return {found->second, static_cast<Get*>(found->second.get())};
 	}
 
-	// Get the object
+	// Get the object (lock-free)
 	template <typename T, typename Get = T>
 	static inline std::shared_ptr<Get> get(u32 id)
 	{
-		reader_lock lock(id_manager::g_mutex);
-
-		const auto found = find_id<T, Get>(id);
+		std::shared_ptr<Get> result;
 
-		if (UNLIKELY(found == nullptr))
+		peek_id<T, Get>(id, [&](id_manager::id_slot& data)
 		{
-			return nullptr;
-		}
+			result = {data.second, static_cast<Get*>(data.second.get())};
+		});
 
-		return {found->second, static_cast<Get*>(found->second.get())};
+		return result;
 	}
 
 	// Get the object, access object under reader lock
@@ -527,8 +596,12 @@ public:
 
 		u32 result = 0;
 
-		for (auto& id : g_map[get_type<T>()])
+		auto& map = g_map[get_type<T>()];
+
+		for (u32 i = 0, size = map.size; i < size; i++)
 		{
+			auto& id = map.slots[i];
+
 			if (id.second)
 			{
 				if (std::is_same<T, Get>::value || id.first.type() == get_type<Get>())
@@ -553,8 +626,12 @@ public:
 
 		reader_lock lock(id_manager::g_mutex);
 
-		for (auto& id : g_map[get_type<T>()])
+		auto& map = g_map[get_type<T>()];
+
+		for (u32 i = 0, size = map.size; i < size; i++)
 		{
+			auto& id = map.slots[i];
+
 			if (auto ptr = static_cast<object_type*>(id.second.get()))
 			{
 				if (std::is_same<T, Get>::value || id.first.type() == get_type<Get>())
@@ -580,7 +657,7 @@ public:
 
 			if (const auto found = find_id<T, Get>(id))
 			{
-				ptr = std::move(found->second);
+				ptr = found->release();
 			}
 			else
 			{
@@ -602,7 +679,7 @@ public:
 
 			if (const auto found = find_id<T, Get>(id))
 			{
-				ptr = std::move(found->second);
+				ptr = found->release();
 			}
 			else
 			{
@@ -628,7 +705,7 @@ public:
 			{
 				func(*static_cast<Get*>(found->second.get()));
 
-				ptr = std::move(found->second);
+				ptr = found->release();
 			}
 			else
 			{
@@ -662,7 +739,7 @@ public:
 					return result_type{{found->second, _ptr}, std::move(ret)};
 				}
 
-				ptr = std::move(found->second);
+				ptr = found->release();
 			}
 			else
 			{
@@ -284,6 +284,16 @@ namespace vm
 			fmt::throw_exception("Memory mapping failed - blame Windows (addr=0x%x, size=0x%x, flags=0x%x)", addr, size, flags);
 		}
 
+		if (g_cfg.core.huge_pages && size >= 0x200000 && !utils::memory_advise_huge(g_base_addr + addr, size))
+		{
+			static atomic_t<bool> s_warned{false};
+
+			if (!s_warned.exchange(true))
+			{
+				LOG_WARNING(MEMORY, "Huge pages are not supported, using normal pages");
+			}
+		}
+
 		if (flags & page_executable)
 		{
 			utils::memory_commit(g_exec_addr + addr, size);
@@ -491,14 +501,67 @@ namespace vm
 		// Add entry
 		m_map[addr] = std::move(shm);
 
+		take_free(addr, size);
 		return true;
 	}
 
+	void block_t::take_free(u32 addr, u32 size)
+	{
+		// Find the free region containing the range
+		const auto upper = m_free.upper_bound(addr);
+		verify(HERE), upper != m_free.begin();
+
+		const auto found = std::prev(upper);
+		const u32 start = found->first;
+		const u64 end = u64{start} + found->second;
+		verify(HERE), u64{addr} + size <= end;
+
+		m_free.erase(found);
+
+		if (addr > start)
+		{
+			m_free.emplace(start, addr - start);
+		}
+
+		if (u64{addr} + size < end)
+		{
+			m_free.emplace(addr + size, static_cast<u32>(end - addr - size));
+		}
+	}
+
+	void block_t::give_free(u32 addr, u32 size)
+	{
+		auto found = m_free.emplace(addr, size).first;
+
+		// Merge with the next region
+		const auto next = std::next(found);
+
+		if (next != m_free.end() && u64{addr} + size == next->first)
+		{
+			found->second += next->second;
+			m_free.erase(next);
+		}
+
+		// Merge with the previous region
+		if (found != m_free.begin())
+		{
+			const auto prev = std::prev(found);
+
+			if (u64{prev->first} + prev->second == addr)
+			{
+				prev->second += found->second;
+				m_free.erase(found);
+			}
+		}
+	}
+
 	block_t::block_t(u32 addr, u32 size, u64 flags)
 		: addr(addr)
 		, size(size)
 		, flags(flags)
 	{
+		m_free.emplace(addr, size);
+
 		// Allocate compressed reservation info area (avoid SPU MMIO area)
 		if (addr != 0xe0000000)
 		{
@@ -579,12 +642,17 @@ namespace vm
 		// Create or import shared memory object
 		std::shared_ptr<utils::shm> shm = src ? std::shared_ptr<utils::shm>(*src) : std::make_shared<utils::shm>(size);
 
-		// Search for an appropriate place (unoptimized)
-		for (u32 addr = ::align(this->addr, align); addr < this->addr + this->size - 1; addr += align)
+		// Search for an appropriate place (first fit in free regions)
+		for (const auto& range : m_free)
 		{
-			if (try_alloc(addr, pflags, std::move(shm)))
+			const u64 end = u64{range.first} + range.second;
+
+			for (u64 addr = ::align<u64>(range.first, align); addr + shm->size() <= end; addr += align)
 			{
-				return addr;
+				if (try_alloc(static_cast<u32>(addr), pflags, std::move(shm)))
+				{
+					return static_cast<u32>(addr);
+				}
 			}
 		}
 
@@ -648,6 +716,7 @@ namespace vm
 
 			// Remove entry
 			m_map.erase(found);
+			give_free(addr, result);
 		}
 
 		// Notify rsx to invalidate range (TODO)
@@ -144,8 +144,15 @@ namespace vm
 		// Mapped regions: addr -> shm handle
 		std::map<u32, std::shared_ptr<utils::shm>> m_map;
 
+		// Free regions: addr -> size (coalesced)
+		std::map<u32, u32> m_free;
+
 		bool try_alloc(u32 addr, u8 flags, std::shared_ptr<utils::shm>&&);
 
+		// Update free regions
+		void take_free(u32 addr, u32 size);
+		void give_free(u32 addr, u32 size);
+
 	public:
 		block_t(u32 addr, u32 size, u64 flags = 0);
 
@@ -483,3 +483,17 @@ struct fmt_class_string<vm::_ptr_base<char>, void> : fmt_class_string<vm::_ptr_b
 {
 	// Classify char* as const char*
 };
+
+namespace logs
+{
+	// Read guest strings when the message is recorded (deferred logging)
+	template<typename AT>
+	struct arg_copy<vm::_ptr_base<const char, AT>, void> : std::integral_constant<u32, arg_text>
+	{
+	};
+
+	template<typename AT>
+	struct arg_copy<vm::_ptr_base<char, AT>, void> : std::integral_constant<u32, arg_text>
+	{
+	};
+}
@@ -3,7 +3,22 @@
 #include "TextureUtils.h"
 #include "../RSXThread.h"
 #include "../rsx_utils.h"
-
+#include "Utilities/sysinfo.h"
+#include "Utilities/Thread.h"
+#include "Emu/IdManager.h"
+
+#include <thread>
+#include <functional>
+
+const bool s_use_ssse3 =
+#ifdef _MSC_VER
+	utils::has_ssse3();
+#elif __SSSE3__
+	true;
+#else
+	false;
+#define _mm_shuffle_epi8
+#endif
 
 namespace
 {
@@ -25,15 +40,233 @@ namespace
 		std::copy(src.begin(), src.end(), dst.begin());
 	}
 
+	// Texel count from which a conversion is split between several threads
+	constexpr u32 s_parallel_texel_threshold = 2048 * 2048;
+
+	// Rows of a single conversion, split in chunks
+	struct texture_upload_job
+	{
+		const std::function<void(u32, u32)>& func;
+		const u32 row_count;
+		const u32 chunk;
+		const u32 chunk_count;
+
+		atomic_t<u32> next{0};
+		atomic_t<u32> done{0};
+
+		texture_upload_job(const std::function<void(u32, u32)>& func, u32 row_count, u32 chunk)
+			: func(func)
+			, row_count(row_count)
+			, chunk(chunk)
+			, chunk_count((row_count + chunk - 1) / chunk)
+		{
+		}
+
+		// Process chunks until none is left (func is only accessed while the job is incomplete)
+		void run()
+		{
+			for (u32 i; (i = next++) < chunk_count;)
+			{
+				func(i * chunk, std::min(row_count, (i + 1) * chunk));
+				done++;
+			}
+		}
+	};
+
+	// Persistent worker threads for large conversions (created on first use, joined on emulation stop)
+	class texture_upload_pool
+	{
+		std::vector<std::shared_ptr<thread_ctrl>> m_threads;
+
+		semaphore<> m_mutex;
+		std::shared_ptr<texture_upload_job> m_job;
+		atomic_t<bool> m_exit{false};
+
+	public:
+		texture_upload_pool()
+			: m_threads(std::min(std::thread::hardware_concurrency(), 8u) - 1)
+		{
+			for (u32 i = 0; i < m_threads.size(); i++)
+			{
+				thread_ctrl::spawn(m_threads[i], fmt::format("RSX Texture Worker %u", i), [this]()
+				{
+					while (!m_exit)
+					{
+						std::shared_ptr<texture_upload_job> job;
+						{
+							semaphore_lock lock(m_mutex);
+							job = m_job;
+						}
+
+						if (job)
+						{
+							job->run();
+						}
+
+						thread_ctrl::wait();
+					}
+				});
+			}
+		}
+
+		~texture_upload_pool()
+		{
+			m_exit = true;
+
+			for (auto& thread : m_threads)
+			{
+				thread->notify();
+				thread->join();
+			}
+		}
+
+		u32 size() const
+		{
+			return ::size32(m_threads) + 1;
+		}
+
+		// Run the job on the worker threads and the calling thread
+		void run(u32 row_count, u32 chunk, const std::function<void(u32, u32)>& func)
+		{
+			const auto job = std::make_shared<texture_upload_job>(func, row_count, chunk);
+			{
+				semaphore_lock lock(m_mutex);
+				m_job = job;
+			}
+
+			for (auto& thread : m_threads)
+			{
+				thread->notify();
+			}
+
+			job->run();
+
+			while (job->done < job->chunk_count)
+			{
+				std::this_thread::yield();
+			}
+
+			semaphore_lock lock(m_mutex);
+
+			if (m_job == job)
+			{
+				m_job.reset();
+			}
+		}
+	};
+
+	/**
+	 * Run func(first_row, last_row) over [0, row_count).
+	 * Large surfaces are split in chunks of even row count between the worker threads and the calling thread.
+	 */
+	template <typename F>
+	void process_rows(u32 row_count, u32 texel_count, F&& func)
+	{
+		const u32 thread_count = std::min(std::thread::hardware_concurrency(), 8u);
+
+		if (texel_count < s_parallel_texel_threshold || thread_count < 2 || row_count < thread_count * 2)
+		{
+			func(0, row_count);
+			return;
+		}
+
+		const auto pool = fxm::get_always<texture_upload_pool>();
+
+		pool->run(row_count, align(row_count / pool->size(), 2), func);
+	}
+
+	template <typename T>
+	void copy_texels_swapped(T* dst, const T* src, u32 count)
+	{
+		static_assert(sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "Unsupported texel size");
+
+		const __m128i mask = sizeof(T) == 2 ? _mm_set_epi8(0xE, 0xF, 0xC, 0xD, 0xA, 0xB, 0x8, 0x9, 0x6, 0x7, 0x4, 0x5, 0x2, 0x3, 0x0, 0x1) :
+			sizeof(T) == 4 ? _mm_set_epi8(0xC, 0xD, 0xE, 0xF, 0x8, 0x9, 0xA, 0xB, 0x4, 0x5, 0x6, 0x7, 0x0, 0x1, 0x2, 0x3) :
+			_mm_set_epi8(0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF, 0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7);
+
+		constexpr u32 texels_per_vector = 16 / sizeof(T);
+		const u32 iterations = count / texels_per_vector;
+
+		const __m128i* src_ptr = reinterpret_cast<const __m128i*>(src);
+		__m128i* dst_ptr = reinterpret_cast<__m128i*>(dst);
+
+		if (LIKELY(s_use_ssse3))
+		{
+			for (u32 i = 0; i < iterations; ++i)
+			{
+				_mm_storeu_si128(dst_ptr + i, _mm_shuffle_epi8(_mm_loadu_si128(src_ptr + i), mask));
+			}
+		}
+		else
+		{
+			for (u32 i = 0; i < iterations; ++i)
+			{
+				__m128i vec = _mm_loadu_si128(src_ptr + i);
+				vec = _mm_or_si128(_mm_slli_epi16(vec, 8), _mm_srli_epi16(vec, 8));
+
+				if (sizeof(T) >= 4)
+				{
+					vec = _mm_or_si128(_mm_slli_epi32(vec, 16), _mm_srli_epi32(vec, 16));
+				}
+
+				if (sizeof(T) == 8)
+				{
+					vec = _mm_shuffle_epi32(vec, 0xB1);
+				}
+
+				_mm_storeu_si128(dst_ptr + i, vec);
+			}
+		}
+
+		for (u32 i = iterations * texels_per_vector; i < count; ++i)
+		{
+			dst[i] = se_storage<T>::swap(src[i]);
+		}
+	}
+
+	// Row copy, with byteswapping for big-endian source formats
+	template <typename T, typename U>
+	void copy_texels(T* dst, const U* src, u32 count)
+	{
+		std::copy(src, src + count, dst);
+	}
+
+	void copy_texels(u16* dst, const be_t<u16>* src, u32 count)
+	{
+		copy_texels_swapped(dst, reinterpret_cast<const u16*>(src), count);
+	}
+
+	void copy_texels(u32* dst, const be_t<u32>* src, u32 count)
+	{
+		copy_texels_swapped(dst, reinterpret_cast<const u32*>(src), count);
+	}
+
+	void copy_texels(u64* dst, const be_t<u64>* src, u32 count)
+	{
+		copy_texels_swapped(dst, reinterpret_cast<const u64*>(src), count);
+	}
+
 struct copy_unmodified_block
 {
 	template<typename T, typename U>
 	static void copy_mipmap_level(gsl::span<T> dst, gsl::span<const U> src, u16 width_in_block, u16 row_count, u16 depth, u32 dst_pitch_in_block, u32 src_pitch_in_block)
 	{
-		size_t row_element_count = dst_pitch_in_block;
 		static_assert(sizeof(T) == sizeof(U), "Type size doesn't match.");
-		for (int row = 0; row < row_count * depth; ++row)
-			copy(dst.subspan(row * dst_pitch_in_block, width_in_block), src.subspan(row * src_pitch_in_block, width_in_block));
+
+		const u32 total_rows = row_count * depth;
+		if (!total_rows)
+			return;
+
+		verify(HERE), (u32)dst.size() >= (total_rows - 1) * dst_pitch_in_block + width_in_block, (u32)src.size() >= (total_rows - 1) * src_pitch_in_block + width_in_block;
+
+		T* dst_ptr = dst.data();
+		const U* src_ptr = src.data();
+
+		process_rows(total_rows, total_rows * width_in_block, [=](u32 first_row, u32 last_row)
+		{
+			for (u32 row = first_row; row < last_row; ++row)
+				copy_texels(dst_ptr + row * dst_pitch_in_block, src_ptr + row * src_pitch_in_block, width_in_block);
+		});
 	}
 };
 
@@ -42,7 +275,39 @@ struct copy_unmodified_block_swizzled
 	template<typename T, typename U>
 	static void copy_mipmap_level(gsl::span<T> dst, gsl::span<const U> src, u16 width_in_block, u16 row_count, u16 depth, u32 dst_pitch_in_block)
 	{
-		if (std::is_same<T, U>::value && dst_pitch_in_block == width_in_block)
+		static_assert(sizeof(T) == sizeof(U), "Type size doesn't match.");
+
+		if (depth == 1)
+		{
+			// Deswizzle raw texels straight into the destination, then fix endianness of each row in place
+			if (!row_count || !width_in_block)
+				return;
+
+			verify(HERE), (u32)dst.size() >= (row_count - 1u) * dst_pitch_in_block + width_in_block;
+
+			std::vector<u32> offsets(width_in_block + row_count);
+			rsx::get_swizzle_offsets(offsets.data(), offsets.data() + width_in_block, width_in_block, row_count);
+
+			T* dst_ptr = dst.data();
+			void* src_ptr = (void*)src.data();
+			const u32* x_offsets = offsets.data();
+			const u32* y_offsets = offsets.data() + width_in_block;
+
+			process_rows(row_count, row_count * width_in_block, [=](u32 first_row, u32 last_row)
+			{
+				rsx::convert_linear_swizzle_rows<T>(src_ptr, dst_ptr, x_offsets, y_offsets, width_in_block, row_count, dst_pitch_in_block * sizeof(T), true, first_row, last_row);
+
+				if (!std::is_same<T, U>::value)
+				{
+					for (u32 row = first_row; row < last_row; ++row)
+					{
+						T* dst_row = dst_ptr + row * dst_pitch_in_block;
+						copy_texels(dst_row, reinterpret_cast<const U*>(dst_row), width_in_block);
+					}
+				}
+			});
+		}
+		else if (std::is_same<T, U>::value && dst_pitch_in_block == width_in_block)
 		{
 			rsx::convert_linear_swizzle_3d<T>((void*)src.data(), (void*)dst.data(), width_in_block, row_count, depth);
 		}
@@ -51,13 +316,13 @@ struct copy_unmodified_block_swizzled
 			std::vector<U> tmp(width_in_block * row_count * depth);
 			rsx::convert_linear_swizzle_3d<U>((void*)src.data(), tmp.data(), width_in_block, row_count, depth);
 
-			gsl::span<U> src_span = tmp;
 			u32 src_offset = 0;
 			u32 dst_offset = 0;
 
 			for (int n = 0; n < row_count * depth; ++n)
 			{
-				copy(dst.subspan(dst_offset, width_in_block), src_span.subspan(src_offset, width_in_block));
+				verify(HERE), dst_offset + width_in_block <= (u32)dst.size();
+				copy_texels(dst.data() + dst_offset, tmp.data() + src_offset, width_in_block);
 				dst_offset += dst_pitch_in_block;
 				src_offset += width_in_block;
 			}
@@ -3,6 +3,7 @@
 #include "../rsx_cache.h"
 #include "../rsx_utils.h"
 #include "TextureUtils.h"
+#include "Utilities/profiler.h"
 
 #include <atomic>
 
@@ -72,6 +73,7 @@ namespace rsx
 		std::deque<u32> read_history;
 
 		u64 cache_tag = 0;
+		u64 content_hash = 0;
 
 		memory_read_flags readback_behaviour = memory_read_flags::flush_once;
 		rsx::texture_create_flags view_flags = rsx::texture_create_flags::default_component_order;
@@ -149,6 +151,11 @@ namespace rsx
 			readback_behaviour = flags;
 		}
 
+		void set_content_hash(u64 hash)
+		{
+			content_hash = hash;
+		}
+
 		u16 get_width() const
 		{
 			return width;
@@ -184,6 +191,11 @@ namespace rsx
 			return readback_behaviour;
 		}
 
+		u64 get_content_hash() const
+		{
+			return content_hash;
+		}
+
 		bool writes_likely_completed() const
 		{
 			// TODO: Move this to the miss statistics block
@@ -456,6 +468,8 @@ namespace rsx
 		std::atomic<u32> m_num_cache_misses = { 0 };
 		std::atomic<u32> m_num_cache_speculative_writes = { 0 };
 		std::atomic<u32> m_num_cache_mispredictions = { 0 };
+		std::atomic<u32> m_num_reused_uploads = { 0 };
+		std::atomic<u64> m_reused_upload_bytes = { 0 };
 
 		/* Helpers */
 		virtual void free_texture_section(section_storage_type&) = 0;
@@ -785,6 +799,55 @@ namespace rsx
 			return {};
 		}
 
+		u64 get_texture_content_hash(const std::vector<rsx_subresource_layout>& subresources_layout, u32 raw_format) const
+		{
+			// Seed with the unmasked format so that linear/swizzled and normalized/unnormalized variants never alias
+			u64 hash = raw_format;
+
+			for (const auto& subresource : subresources_layout)
+			{
+				hash = rpcs3::hash_range(subresource.data.data(), subresource.data.size_bytes(), hash);
+			}
+
+			return hash;
+		}
+
+		/**
+		 * Look for a shader_read section invalidated by a CPU write whose memory contents did not actually change.
+		 * Such a section still holds a valid image; it is locked again and reused without decoding anything.
+		 */
+		section_storage_type* find_unmodified_texture(u32 rsx_address, u32 rsx_size, u16 width, u16 height, u16 depth, u16 mipmaps, u32 gcm_format, u64 content_hash)
+		{
+			auto found = m_cache.find(get_block_address(rsx_address));
+			if (found == m_cache.end())
+				return nullptr;
+
+			for (auto &tex : found->second.data)
+			{
+				if (!tex.is_dirty() || !tex.exists() || tex.is_locked())
+					continue;
+
+				if (tex.get_context() != rsx::texture_upload_context::shader_read ||
+					tex.get_content_hash() != content_hash ||
+					tex.get_gcm_format() != gcm_format ||
+					tex.mipmaps != mipmaps ||
+					!tex.matches(rsx_address, rsx_size) ||
+					!tex.matches(rsx_address, width, height, depth, mipmaps))
+					continue;
+
+				tex.set_dirty(false);
+				tex.protect(utils::protection::ro);
+				read_only_range = tex.get_min_max(read_only_range);
+
+				found->second.notify();
+				m_unreleased_texture_objects--;
+				update_cache_tag();
+				return &tex;
+			}
+
+			return nullptr;
+		}
+
 		inline bool is_hw_blit_engine_compatible(u32 format) const
 		{
 			switch (format)
@@ -1207,6 +1270,7 @@ namespace rsx
 			if (!region_intersects_cache(address, range, is_writing))
 				return{};
 
+			prof::scoped_zone zone("texture cache invalidate", address);
 			writer_lock lock(m_cache_mutex);
 			return invalidate_range_impl_base(address, range, is_writing, false, true, allow_flush, std::forward<Args>(extras)...);
 		}
@@ -1218,6 +1282,7 @@ namespace rsx
 			if (!region_intersects_cache(address, range, is_writing))
 				return {};
 
+			prof::scoped_zone zone("texture cache invalidate", address);
 			writer_lock lock(m_cache_mutex);
 			return invalidate_range_impl_base(address, range, is_writing, discard, false, allow_flush, std::forward<Args>(extras)...);
 		}
@@ -1703,6 +1768,8 @@ namespace rsx
 		sampled_image_descriptor upload_texture(commandbuffer_type& cmd, RsxTextureType& tex, surface_store_type& m_rtts, Args&&... extras)
 		{
 			const u32 texaddr = rsx::get_address(tex.offset(), tex.location());
+			prof::scoped_zone zone("texture cache lookup", texaddr);
+
 			const u32 tex_size = (u32)get_placed_texture_storage_size(tex, 256, 512);
 			const u32 format = tex.format() & ~(CELL_GCM_TEXTURE_LN | CELL_GCM_TEXTURE_UN);
 			const bool is_compressed_format = (format == CELL_GCM_TEXTURE_COMPRESSED_DXT1 || format == CELL_GCM_TEXTURE_COMPRESSED_DXT23 || format == CELL_GCM_TEXTURE_COMPRESSED_DXT45);
@@ -1907,10 +1974,31 @@ namespace rsx
 			//Invalidate with writing=false, discard=false, rebuild=false, native_flush=true
 			invalidate_range_impl_base(texaddr, tex_size, false, false, false, true, std::forward<Args>(extras)...);
 
+			const u16 mipmaps = tex.get_exact_mipmap_count();
+			u64 content_hash = 0;
+
+			if (g_cfg.video.reuse_unmodified_textures)
+			{
+				content_hash = get_texture_content_hash(subresources_layout, tex.format());
+
+				if (auto unmodified = find_unmodified_texture(texaddr, tex_pitch * tex_height, tex_width, tex_height, depth, mipmaps, format, content_hash))
+				{
+					m_num_reused_uploads++;
+					m_reused_upload_bytes += unmodified->get_section_size();
+					rsx::get_current_renderer()->performance_counters.reused_texture_bytes += unmodified->get_section_size();
+
+					return{ unmodified->get_view(tex.remap(), tex.decoded_remap()), texture_upload_context::shader_read, is_depth_format, scale_x, scale_y, extended_dimension };
+				}
+			}
+
 			//NOTE: SRGB correction is to be handled in the fragment shader; upload as linear RGB
 			m_texture_memory_in_use += (tex_pitch * tex_height);
-			return{ upload_image_from_cpu(cmd, texaddr, tex_width, tex_height, depth, tex.get_exact_mipmap_count(), tex_pitch, format,
-				texture_upload_context::shader_read, subresources_layout, extended_dimension, is_swizzled)->get_view(tex.remap(), tex.decoded_remap()),
+			auto section = upload_image_from_cpu(cmd, texaddr, tex_width, tex_height, depth, mipmaps, tex_pitch, format,
+				texture_upload_context::shader_read, subresources_layout, extended_dimension, is_swizzled);
+
+			section->set_content_hash(content_hash);
+
+			return{ section->get_view(tex.remap(), tex.decoded_remap()),
 				texture_upload_context::shader_read, is_depth_format, scale_x, scale_y, extended_dimension };
 		}
 
@@ -2459,6 +2547,7 @@ namespace rsx
 			m_num_cache_misses.store(0u);
 			m_num_cache_mispredictions.store(0u);
 			m_num_cache_speculative_writes.store(0u);
+			m_num_reused_uploads.store(0u);
 		}
 
 		virtual const u32 get_unreleased_textures_count() const
@@ -2486,6 +2575,16 @@ namespace rsx
 			return m_num_cache_speculative_writes;
 		}
 
+		virtual u32 get_num_reused_uploads() const
+		{
+			return m_num_reused_uploads;
+		}
+
+		virtual u64 get_reused_upload_bytes() const
+		{
+			return m_reused_upload_bytes;
+		}
+
 		virtual f32 get_cache_miss_ratio() const
 		{
 			const auto num_flushes = m_num_flush_requests.load();
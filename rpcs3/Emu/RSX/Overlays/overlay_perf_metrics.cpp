@@ -239,6 +239,7 @@ namespace rsx
 				f32 spu_usage{0};
 				f32 rsx_usage{0};
 				u32 rsx_load{0};
+				f32 reused_texture_mb{0};
 
 				std::shared_ptr<GSRender> rsx_thread;
 
@@ -253,6 +254,7 @@ namespace rsx
 
 					rsx_thread = fxm::get<GSRender>();
 					rsx_load = rsx_thread->get_load();
+					reused_texture_mb = rsx_thread->performance_counters.reused_texture_bytes.load() / (1024.f * 1024.f);
 
 					total_threads = CPUStats::get_thread_count();
 
@@ -330,6 +332,11 @@ namespace rsx
 					                         "%s\n"
 					                         " RSX   : %02u %%",
 					    fps, frametime, std::string(title1_high.size(), ' '), ppu_usage, ppus, spu_usage, spus + rawspus, rsx_usage, cpu_usage, total_threads, std::string(title2.size(), ' '), rsx_load);
+
+					if (g_cfg.video.reuse_unmodified_textures)
+					{
+						perf_text += fmt::format("\n Reused textures : %.1f MiB", reused_texture_mb);
+					}
 					break;
 				}
 				}
@@ -16,6 +16,7 @@
 
 #include "Utilities/GSL.h"
 #include "Utilities/StrUtil.h"
+#include "Utilities/profiler.h"
 
 #include <thread>
 #include <unordered_set>
@@ -975,6 +976,7 @@ namespace rsx
 				{
 					if (auto method = methods[reg])
 					{
+						prof::scoped_zone zone("RSX method", reg);
 						method(this, reg, value);
 					}
 				}
@@ -346,6 +346,7 @@ namespace rsx
 			FIFO_state state = FIFO_state::running;
 			u32 approximate_load = 0;
 			u32 sampled_frames = 0;
+			atomic_t<u64> reused_texture_bytes{ 0 }; // Texture uploads skipped because guest memory was unchanged
 		}
 		performance_counters;
 
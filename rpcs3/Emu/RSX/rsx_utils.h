@@ -332,17 +332,14 @@ namespace rsx
 		return result;
 	}
 
-	/*   Note: What the ps3 calls swizzling in this case is actually z-ordering / morton ordering of pixels
-	*       - Input can be swizzled or linear, bool flag handles conversion to and from
-	*       - It will handle any width and height that are a power of 2, square or non square
-	*    Restriction: It has mixed results if the height or width is not a power of 2
-	*    Restriction: Only works with 2D surfaces
-	*/
-	template<typename T>
-	void convert_linear_swizzle(void* input_pixels, void* output_pixels, u16 width, u16 height, u32 pitch, bool input_is_swizzled)
+	/**
+	 * Fill per-axis offset tables for z-ordered (morton) addressing of a 2D surface.
+	 * The swizzled offset of texel (x, y) is x_offsets[x] + y_offsets[y].
+	 */
+	static inline void get_swizzle_offsets(u32* x_offsets, u32* y_offsets, u16 width, u16 height)
 	{
-		u32 log2width = ceil_log2(width);
-		u32 log2height = ceil_log2(height);
+		const u32 log2width = ceil_log2(width);
+		const u32 log2height = ceil_log2(height);
 
 		// Max mask possible for square texture
 		u32 x_mask = 0x55555555;
@@ -358,59 +355,128 @@ namespace rsx
 		//y_mask. bits above limit are 0'd, as we use a different method for y-carry over
 		y_mask = (y_mask & (limit_mask - 1));
 
-		u32 offs_y = 0;
 		u32 offs_x = 0;
-		u32 offs_x0 = 0; //total y-carry offset for x
-		u32 y_incr = limit_mask;
+		for (u32 x = 0; x < width; ++x)
+		{
+			x_offsets[x] = offs_x;
+			offs_x = (offs_x - x_mask) & x_mask;
+		}
 
-		u32 adv = pitch / sizeof(T);
+		u32 offs_y = 0;
+		u32 offs_x0 = 0; //total y-carry offset for x
+		const u32 y_incr = limit_mask;
 
-		if (!input_is_swizzled)
+		for (u32 y = 0; y < height; ++y)
 		{
-			for (int y = 0; y < height; ++y)
+			y_offsets[y] = offs_y + offs_x0;
+			offs_y = (offs_y - y_mask) & y_mask;
+
+			if (offs_y == 0)
 			{
-				T* src = static_cast<T*>(input_pixels) + y * adv;
-				T *dst = static_cast<T*>(output_pixels) + offs_y;
-				offs_x = offs_x0;
+				offs_x0 += y_incr;
+			}
+		}
+	}
 
-				for (int x = 0; x < width; ++x)
-				{
-					dst[offs_x] = src[x];
-					offs_x = (offs_x - x_mask) & x_mask;
-				}
+	/**
+	 * Convert rows [first_row, last_row) of a 2D surface using the tables from get_swizzle_offsets.
+	 * Rows are independent of each other, so large surfaces can be split between several threads.
+	 */
+	template<typename T>
+	void convert_linear_swizzle_rows(void* input_pixels, void* output_pixels, const u32* x_offsets, const u32* y_offsets, u16 width, u16 height, u32 pitch, bool input_is_swizzled, u16 first_row, u16 last_row)
+	{
+		T* src_base = static_cast<T*>(input_pixels);
+		T* dst_base = static_cast<T*>(output_pixels);
+		const u32 adv = pitch / sizeof(T);
 
-				offs_y = (offs_y - y_mask) & y_mask;
+		// With 32-bit texels, a 4x2 block is stored as 8 consecutive swizzled texels (two 2x2 quads)
+		// This holds if x bit 0, y bit 0 and x bit 1 map to offset bits 0, 1 and 2, which is checked on the tables
+		const bool use_blocks = sizeof(T) == 4 && (width % 4) == 0 && (height % 2) == 0 &&
+			width >= 4 && x_offsets[1] == 1 && x_offsets[2] == 4 && y_offsets[1] == 2;
 
-				if (offs_y == 0)
+		for (u32 y = first_row; y < last_row; ++y)
+		{
+			const u32 offs_y = y_offsets[y];
+
+			if (use_blocks && (y % 2) == 0 && (y + 1) < last_row)
+			{
+				if (input_is_swizzled)
+				{
+					T* dst0 = dst_base + y * adv;
+					T* dst1 = dst0 + adv;
+
+					for (u32 x = 0; x < width; x += 4)
+					{
+						const __m128i* block = reinterpret_cast<const __m128i*>(src_base + offs_y + x_offsets[x]);
+						const __m128i quad0 = _mm_loadu_si128(block);
+						const __m128i quad1 = _mm_loadu_si128(block + 1);
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(dst0 + x), _mm_unpacklo_epi64(quad0, quad1));
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(dst1 + x), _mm_unpackhi_epi64(quad0, quad1));
+					}
+				}
+				else
 				{
-					offs_x0 += y_incr;
+					const T* src0 = src_base + y * adv;
+					const T* src1 = src0 + adv;
+
+					for (u32 x = 0; x < width; x += 4)
+					{
+						__m128i* block = reinterpret_cast<__m128i*>(dst_base + offs_y + x_offsets[x]);
+						const __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src0 + x));
+						const __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1 + x));
+						_mm_storeu_si128(block, _mm_unpacklo_epi64(row0, row1));
+						_mm_storeu_si128(block + 1, _mm_unpackhi_epi64(row0, row1));
+					}
 				}
+
+				// Second row of the block is done
+				++y;
+				continue;
 			}
-		}
-		else
-		{
-			for (int y = 0; y < height; ++y)
+
+			if (input_is_swizzled)
 			{
-				T *src = static_cast<T*>(input_pixels) + offs_y;
-				T* dst = static_cast<T*>(output_pixels) + y * adv;
-				offs_x = offs_x0;
+				const T* src = src_base + offs_y;
+				T* dst = dst_base + y * adv;
 
-				for (int x = 0; x < width; ++x)
+				for (u32 x = 0; x < width; ++x)
 				{
-					dst[x] = src[offs_x];
-					offs_x = (offs_x - x_mask) & x_mask;
+					dst[x] = src[x_offsets[x]];
 				}
+			}
+			else
+			{
+				const T* src = src_base + y * adv;
+				T* dst = dst_base + offs_y;
 
-				offs_y = (offs_y - y_mask) & y_mask;
-
-				if (offs_y == 0)
+				for (u32 x = 0; x < width; ++x)
 				{
-					offs_x0 += y_incr;
+					dst[x_offsets[x]] = src[x];
 				}
 			}
 		}
 	}
 
+	/*   Note: What the ps3 calls swizzling in this case is actually z-ordering / morton ordering of pixels
+	*       - Input can be swizzled or linear, bool flag handles conversion to and from
+	*       - It will handle any width and height that are a power of 2, square or non square
+	*    Restriction: It has mixed results if the height or width is not a power of 2
+	*    Restriction: Only works with 2D surfaces
+	*/
+	template<typename T>
+	void convert_linear_swizzle(void* input_pixels, void* output_pixels, u16 width, u16 height, u32 pitch, bool input_is_swizzled)
+	{
+		if (!width || !height)
+		{
+			return;
+		}
+
+		std::vector<u32> offsets(width + height);
+		get_swizzle_offsets(offsets.data(), offsets.data() + width, width, height);
+
+		convert_linear_swizzle_rows<T>(input_pixels, output_pixels, offsets.data(), offsets.data() + width, width, height, pitch, input_is_swizzled, 0, height);
+	}
+
 	/**
 	 * Write swizzled data to linear memory with support for 3 dimensions
 	 * Z ordering is done in all 3 planes independently with a unit being a 2x2 block per-plane
@@ -429,13 +495,25 @@ namespace rsx
 		T *src = static_cast<T*>(input_pixels);
 		T *dst = static_cast<T*>(output_pixels);
 
+		// Bits of each coordinate are interleaved independently, so z-index(x, y, z) = z-index(x, 0, 0) | z-index(0, y, 0) | z-index(0, 0, z)
+		std::vector<u32> offsets(width + height + depth);
+		u32* x_offsets = offsets.data();
+		u32* y_offsets = x_offsets + width;
+		u32* z_offsets = y_offsets + height;
+
+		for (u32 x = 0; x < width; ++x) x_offsets[x] = calculate_z_index(x, 0, 0);
+		for (u32 y = 0; y < height; ++y) y_offsets[y] = calculate_z_index(0, y, 0);
+		for (u32 z = 0; z < depth; ++z) z_offsets[z] = calculate_z_index(0, 0, z);
+
 		for (u32 z = 0; z < depth; ++z)
 		{
 			for (u32 y = 0; y < height; ++y)
 			{
+				const T* src_row = src + (z_offsets[z] | y_offsets[y]);
+
 				for (u32 x = 0; x < width; ++x)
 				{
-					*dst++ = src[calculate_z_index(x, y, z)];
+					*dst++ = src_row[x_offsets[x]];
 				}
 			}
 		}
@@ -20,9 +20,12 @@
 
 #include "Loader/PSF.h"
 #include "Loader/ELF.h"
+#include "Loader/ISO.h"
+#include "Loader/PUP.h"
 
 #include "Utilities/StrUtil.h"
 #include "Utilities/sysinfo.h"
+#include "Utilities/profiler.h"
 
 #include "../Crypto/unself.h"
 #include "../Crypto/unpkg.h"
@@ -489,6 +492,12 @@ bool Emulator::BootGame(const std::string& path, bool direct, bool add_only)
 		"/USRDIR/ISO.BIN.EDAT",
 	};
 
+	// Boot from the root of the disc image
+	if (iso_is_image(path))
+	{
+		return iso_mount("//iso", path) && BootGame("//iso", false, add_only);
+	}
+
 	if (direct && fs::exists(path))
 	{
 		m_path = path;
@@ -554,6 +563,41 @@ bool Emulator::InstallPkg(const std::string& path)
 	return false;
 }
 
+bool Emulator::InstallPup(const std::string& path)
+{
+	LOG_SUCCESS(GENERAL, "Installing firmware: %s", path);
+
+	atomic_t<double> progress(0.);
+	bool result = false;
+	int int_progress = 0;
+	{
+		// Run firmware installation asynchronously
+		scope_thread worker("PUP Installer", [&]
+		{
+			result = pup_install(path, g_cfg.vfs.get_dev_flash(), progress);
+
+			if (!result)
+			{
+				progress = -1.;
+			}
+		});
+
+		// Wait for the completion
+		while (std::this_thread::sleep_for(5ms), std::abs(progress) < 1.)
+		{
+			const int pval = static_cast<int>(progress * 100.);
+
+			if (pval > int_progress)
+			{
+				int_progress = pval;
+				LOG_SUCCESS(GENERAL, "... %u%%", int_progress);
+			}
+		}
+	}
+
+	return result;
+}
+
 std::string Emulator::GetEmuDir()
 {
 	const std::string& emu_dir_ = g_cfg.vfs.emulator_dir;
@@ -693,6 +737,8 @@ void Emulator::Load(bool add_only)
 
 		LOG_NOTICE(LOADER, "Used configuration:\n%s\n", g_cfg.to_string());
 
+		logs::set_deferred(static_cast<bool>(g_cfg.misc.deferred_log));
+
 		// Set RTM usage
 		g_use_rtm = utils::has_rtm() && ((utils::has_mpx() && g_cfg.core.enable_TSX == tsx_usage::enabled) || g_cfg.core.enable_TSX == tsx_usage::forced);
 		if (g_use_rtm && !utils::has_mpx())
@@ -900,6 +946,12 @@ void Emulator::Load(bool add_only)
 			}
 		}
 
+		// Mount disc image (stored in the game list or set in the config)
+		if (!bdvd_dir.empty() && iso_is_image(bdvd_dir))
+		{
+			bdvd_dir = iso_mount("//iso", bdvd_dir) ? "//iso/" : "";
+		}
+
 		// Check /dev_bdvd/
 		if (disc.empty() && !bdvd_dir.empty() && fs::is_dir(bdvd_dir))
 		{
@@ -922,8 +974,9 @@ void Emulator::Load(bool add_only)
 				return;
 			}
 
-			// Store /dev_bdvd/ location
-			games[m_title_id] = bdvd_dir;
+			// Store /dev_bdvd/ location (image file path if mounted from the disc image)
+			const auto iso = std::dynamic_pointer_cast<iso_device>(fs::get_virtual_device(bdvd_dir));
+			games[m_title_id] = iso ? iso->get_image_path() : bdvd_dir;
 			YAML::Emitter out;
 			out << games;
 			fs::file(fs::get_config_dir() + "/games.yml", fs::rewrite).write(out.c_str(), out.size());
@@ -1241,6 +1294,11 @@ void Emulator::Run()
 	m_pause_amend_time = 0;
 	m_state = system_state::running;
 
+	if (g_cfg.misc.write_trace)
+	{
+		prof::start(fs::get_config_dir() + "trace.json");
+	}
+
 	auto on_select = [](u32, cpu_thread& cpu)
 	{
 		cpu.run();
@@ -1403,6 +1461,9 @@ void Emulator::Stop(bool restart)
 
 	LOG_NOTICE(GENERAL, "Objects cleared...");
 
+	prof::stop();
+	logs::set_deferred(false);
+
 	vm::close();
 
 	if (do_exit)
@@ -302,6 +302,7 @@ public:
 	bool BootGame(const std::string& path, bool direct = false, bool add_only = false);
 	bool BootRsxCapture(const std::string& path);
 	bool InstallPkg(const std::string& path);
+	bool InstallPup(const std::string& path);
 
 private:
 	static std::string GetEmuDir();
@@ -342,18 +343,22 @@ struct cfg_root : cfg::node
 		cfg::_enum<ppu_decoder_type> ppu_decoder{this, "PPU Decoder", ppu_decoder_type::llvm};
 		cfg::_int<1, 16> ppu_threads{this, "PPU Threads", 2}; // Amount of PPU threads running simultaneously (must be 2)
 		cfg::_bool ppu_debug{this, "PPU Debug"};
+		cfg::_bool ppu_block_interpreter{this, "PPU Block Interpreter", true}; // Execute pre-decoded basic blocks (interpreters only)
 		cfg::_bool llvm_logs{this, "Save LLVM logs"};
 		cfg::string llvm_cpu{this, "Use LLVM CPU"};
 		cfg::_int<0, INT32_MAX> llvm_threads{this, "Max LLVM Compile Threads", 0};
 		cfg::_bool thread_scheduler_enabled{this, "Enable thread scheduler", thread_scheduler_enabled_def};
 		cfg::_bool set_daz_and_ftz{this, "Set DAZ and FTZ", false};
+		cfg::_bool huge_pages{this, "Use huge pages", false}; // Back large guest allocations with huge pages (Linux)
 		cfg::_enum<spu_decoder_type> spu_decoder{this, "SPU Decoder", spu_decoder_type::asmjit};
 		cfg::_bool lower_spu_priority{this, "Lower SPU thread priority"};
 		cfg::_bool spu_debug{this, "SPU Debug"};
+		cfg::_bool spu_block_interpreter{this, "SPU Block Interpreter", false}; // Execute pre-decoded basic blocks (interpreters only)
 		cfg::_int<0, 6> preferred_spu_threads{this, "Preferred SPU Threads", 0}; //Numnber of hardware threads dedicated to heavy simultaneous spu tasks
 		cfg::_int<0, 16> spu_delay_penalty{this, "SPU delay penalty", 3}; //Number of milliseconds to block a thread if a virtual 'core' isn't free
 		cfg::_bool spu_loop_detection{this, "SPU loop detection", true}; //Try to detect wait loops and trigger thread yield
 		cfg::_bool spu_shared_runtime{this, "SPU Shared Runtime", true}; // Share compiled SPU functions between all threads
+		cfg::_bool spu_async_compile{this, "SPU Asynchronous Compilation", true}; // Interpret new blocks while they are compiled in background (requires shared runtime)
 		cfg::_enum<spu_block_size_type> spu_block_size{this, "SPU Block Size", spu_block_size_type::safe};
 		cfg::_bool spu_accurate_getllar{this, "Accurate GETLLAR", false};
 		cfg::_bool spu_accurate_putlluc{this, "Accurate PUTLLUC", false};
@@ -361,6 +366,7 @@ struct cfg_root : cfg::node
 		cfg::_bool spu_cache{this, "SPU Cache", true};
 		cfg::_enum<tsx_usage> enable_TSX{this, "Enable TSX", tsx_usage::enabled}; // Enable TSX. Forcing this on Haswell/Broadwell CPUs should be used carefully
 		cfg::_bool spu_accurate_xfloat{this, "Accurate xfloat", false};
+		cfg::_int<0, 16> vdec_threads{this, "Video Decoder Threads", 0}; // 0 = auto, 1 = decode and convert pictures synchronously
 
 		cfg::_enum<lib_loading_type> lib_loading{this, "Lib Loader", lib_loading_type::liblv2only};
 		cfg::_bool hook_functions{this, "Hook static functions"};
@@ -388,6 +394,7 @@ struct cfg_root : cfg::node
 		}
 
 		cfg::_bool host_root{this, "Enable /host_root/"};
+		cfg::_bool async_savedata{this, "Write save data asynchronously", true};
 
 	} vfs{this};
 
@@ -423,6 +430,7 @@ struct cfg_root : cfg::node
 		cfg::_bool disable_vulkan_mem_allocator{this, "Disable Vulkan Memory Allocator", false};
 		cfg::_bool full_rgb_range_output{this, "Use full RGB output range", true}; // Video out dynamic range
 		cfg::_bool disable_asynchronous_shader_compiler{this, "Disable Asynchronous Shader Compiler", false};
+		cfg::_bool reuse_unmodified_textures{this, "Reuse Unmodified Textures", false}; // Hash texture memory to skip re-uploading identical data
 		cfg::_int<1, 8> consequtive_frames_to_draw{this, "Consecutive Frames To Draw", 1};
 		cfg::_int<1, 8> consequtive_frames_to_skip{this, "Consecutive Frames To Skip", 1};
 		cfg::_int<50, 800> resolution_scale_percent{this, "Resolution Scale", 100};
@@ -537,6 +545,9 @@ struct cfg_root : cfg::node
 		cfg::_bool show_shader_compilation_hint{ this, "Show shader compilation hint", true };
 		cfg::_bool use_native_interface{ this, "Use native user interface", true };
 		cfg::_int<1, 65535> gdb_server_port{this, "Port", 2345};
+		cfg::_bool write_trace{this, "Write trace file"}; // Record profiler zones to trace.json (Chrome trace format)
+		cfg::_bool profile_sync_objects{this, "Profile sync objects"}; // Collect lv2 mutex/cond/semaphore/event queue contention statistics
+		cfg::_bool deferred_log{this, "Deferred logging"}; // Format log messages (except errors) in the background thread
 
 	} misc{this};
 
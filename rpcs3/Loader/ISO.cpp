@@ -0,0 +1,645 @@
+#include "stdafx.h"
+#include "ISO.h"
+#include "Utilities/StrUtil.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+constexpr u64 s_sector_size = 2048;
+
+// Read-ahead window for sequential reads
+constexpr u64 s_read_ahead = 4 * 1024 * 1024;
+
+struct iso_image
+{
+	fs::file file;
+	const u8* data = nullptr;
+	u64 size = 0;
+
+#ifdef _WIN32
+	HANDLE mapping = nullptr;
+#endif
+
+	explicit iso_image(const std::string& path)
+		: file(path)
+	{
+		if (!file || (size = file.size()) == 0)
+		{
+			return;
+		}
+
+#ifdef _WIN32
+		mapping = ::CreateFileMappingW(file.get_handle(), nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (mapping)
+		{
+			data = static_cast<const u8*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+#else
+		void* ptr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file.get_handle(), 0);
+
+		if (ptr != MAP_FAILED)
+		{
+			data = static_cast<const u8*>(ptr);
+		}
+#endif
+	}
+
+	iso_image(const iso_image&) = delete;
+
+	~iso_image()
+	{
+#ifdef _WIN32
+		if (data) ::UnmapViewOfFile(data);
+		if (mapping) ::CloseHandle(mapping);
+#else
+		if (data) ::munmap(const_cast<u8*>(data), size);
+#endif
+	}
+
+	// Ask the OS to start reading the range in background
+	void prefetch(u64 offset, u64 count) const
+	{
+#ifndef _WIN32
+		const u64 start = offset & ~u64{4095};
+		::madvise(const_cast<u8*>(data + start), offset + count - start, MADV_WILLNEED);
+#else
+		// The cache manager already reads ahead on sequential page faults in mapped views
+#endif
+	}
+};
+
+// Read 32-bit little-endian field of the both-endian pair
+static u32 iso_read32(const u8* ptr)
+{
+	return ptr[0] | ptr[1] << 8 | ptr[2] << 16 | u32{ptr[3]} << 24;
+}
+
+// Convert 7-byte directory record timestamp to POSIX time
+static s64 iso_read_time(const u8* ptr)
+{
+	const s64 month = ptr[1];
+
+	if (month < 1 || month > 12)
+	{
+		return 0;
+	}
+
+	// Days from civil (years starting in March)
+	const s64 year = ptr[0] + 1900 - (month <= 2);
+	const s64 era = year / 400;
+	const s64 yoe = year - era * 400;
+	const s64 doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + ptr[2] - 1;
+	const s64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	const s64 days = era * 146097 + doe - 719468;
+
+	// The last byte is the offset from GMT in 15 minute intervals
+	return days * 86400 + ptr[3] * 3600 + ptr[4] * 60 + ptr[5] - static_cast<s8>(ptr[6]) * 900;
+}
+
+// Call func(image offset, size, bytes done) for every contiguous part of the file range
+template <typename F>
+static u64 iso_for_each_part(const std::vector<iso_device::extent>& extents, u64 offset, u64 count, F&& func)
+{
+	u64 done = 0;
+
+	for (const auto& ext : extents)
+	{
+		if (offset >= ext.size)
+		{
+			offset -= ext.size;
+			continue;
+		}
+
+		if (done == count)
+		{
+			break;
+		}
+
+		const u64 part = std::min<u64>(ext.size - offset, count - done);
+		func(ext.offset + offset, part, done);
+		done += part;
+		offset = 0;
+	}
+
+	return done;
+}
+
+class iso_file final : public fs::file_base
+{
+	const std::shared_ptr<iso_image> m_image;
+	const std::vector<iso_device::extent> m_extents;
+	const fs::stat_t m_stat;
+
+	u64 m_pos = 0;
+	u64 m_last = 0; // End of the previous read
+	u64 m_ahead = 0; // End of the requested read-ahead
+
+public:
+	iso_file(const std::shared_ptr<iso_image>& image, const iso_device::entry& entry)
+		: m_image(image)
+		, m_extents(entry.extents)
+		, m_stat{false, false, entry.size, entry.mtime, entry.mtime, entry.mtime}
+	{
+	}
+
+	fs::stat_t stat() override
+	{
+		return m_stat;
+	}
+
+	bool trunc(u64 length) override
+	{
+		fs::g_tls_error = fs::error::acces;
+		return false;
+	}
+
+	u64 read(void* buffer, u64 count) override
+	{
+		if (m_pos >= m_stat.size)
+		{
+			return 0;
+		}
+
+		count = std::min<u64>(count, m_stat.size - m_pos);
+
+		const u64 result = iso_for_each_part(m_extents, m_pos, count, [&](u64 offset, u64 size, u64 done)
+		{
+			std::memcpy(static_cast<u8*>(buffer) + done, m_image->data + offset, size);
+		});
+
+		// Keep the read-ahead window in front of sequential reads
+		if (m_pos == m_last && m_pos + result + s_read_ahead / 2 > m_ahead)
+		{
+			const u64 start = std::max<u64>(m_pos + result, m_ahead);
+			const u64 end = std::min<u64>(m_pos + result + s_read_ahead, m_stat.size);
+
+			if (start < end)
+			{
+				iso_for_each_part(m_extents, start, end - start, [&](u64 offset, u64 size, u64)
+				{
+					m_image->prefetch(offset, size);
+				});
+			}
+
+			m_ahead = end;
+		}
+
+		m_pos += result;
+		m_last = m_pos;
+		return result;
+	}
+
+	u64 write(const void* buffer, u64 count) override
+	{
+		fs::g_tls_error = fs::error::acces;
+		return 0;
+	}
+
+	u64 seek(s64 offset, fs::seek_mode whence) override
+	{
+		const s64 new_pos =
+			whence == fs::seek_set ? offset :
+			whence == fs::seek_cur ? offset + m_pos :
+			whence == fs::seek_end ? offset + m_stat.size :
+			(fmt::raw_error("iso_file::seek(): invalid whence"), 0);
+
+		if (new_pos < 0)
+		{
+			fs::g_tls_error = fs::error::inval;
+			return -1;
+		}
+
+		m_pos = new_pos;
+		return m_pos;
+	}
+
+	u64 size() override
+	{
+		return m_stat.size;
+	}
+};
+
+class iso_dir final : public fs::dir_base
+{
+	std::vector<fs::dir_entry> m_entries;
+	std::size_t m_pos = 0;
+
+public:
+	iso_dir(std::vector<fs::dir_entry>&& entries)
+		: m_entries(std::move(entries))
+	{
+	}
+
+	bool read(fs::dir_entry& out) override
+	{
+		if (m_pos >= m_entries.size())
+		{
+			return false;
+		}
+
+		out = m_entries[m_pos++];
+		return true;
+	}
+
+	void rewind() override
+	{
+		m_pos = 0;
+	}
+};
+
+iso_device::iso_device(const std::string& root, const std::string& path)
+	: m_root(root)
+	, m_path(path)
+	, m_image(std::make_shared<iso_image>(path))
+{
+	if (!m_image->data)
+	{
+		LOG_ERROR(LOADER, "ISO: failed to open '%s'", path);
+		return;
+	}
+
+	// Find the primary volume descriptor
+	for (u64 pos = 16 * s_sector_size; pos + s_sector_size <= m_image->size; pos += s_sector_size)
+	{
+		const u8* const desc = m_image->data + pos;
+
+		if (std::memcmp(desc + 1, "CD001", 5) != 0 || desc[0] == 255)
+		{
+			break;
+		}
+
+		if (desc[0] != 1)
+		{
+			continue;
+		}
+
+		if ((desc[128] | desc[129] << 8) != s_sector_size)
+		{
+			LOG_ERROR(LOADER, "ISO: unsupported block size %u in '%s'", desc[128] | desc[129] << 8, path);
+			return;
+		}
+
+		// Root directory record
+		const u8* const rec = desc + 156;
+
+		entry root_dir{};
+		root_dir.is_dir = true;
+		root_dir.size = iso_read32(rec + 10);
+		root_dir.mtime = iso_read_time(rec + 18);
+		root_dir.extents.push_back({iso_read32(rec + 2) * s_sector_size, root_dir.size});
+
+		m_entries.emplace_back(std::move(root_dir));
+		m_index.emplace("", 0);
+
+		if (!read_dir(0, "", 0))
+		{
+			LOG_ERROR(LOADER, "ISO: corrupted directory tree in '%s'", path);
+			m_entries.clear();
+			m_index.clear();
+			return;
+		}
+
+		LOG_NOTICE(LOADER, "ISO: indexed %u entries in '%s'", m_entries.size(), path);
+		return;
+	}
+
+	LOG_ERROR(LOADER, "ISO: primary volume descriptor not found in '%s'", path);
+}
+
+bool iso_device::read_dir(u32 dir, const std::string& path, u32 depth)
+{
+	if (depth > 64)
+	{
+		// Directory cycle
+		return false;
+	}
+
+	// Copy because m_entries grows
+	const std::vector<extent> extents = m_entries[dir].extents;
+
+	std::vector<u32> subdirs;
+	u32 continued = -1;
+
+	for (const auto& ext : extents)
+	{
+		if (ext.offset > m_image->size || m_image->size - ext.offset < ext.size)
+		{
+			return false;
+		}
+
+		const u8* const data = m_image->data + ext.offset;
+
+		for (u64 pos = 0; pos < ext.size;)
+		{
+			const u8* const rec = data + pos;
+			const u32 len = rec[0];
+
+			if (len == 0)
+			{
+				// Records don't cross sector boundaries, skip padding
+				pos = ::align(pos + 1, s_sector_size);
+				continue;
+			}
+
+			if (len < 34 || len > ext.size - pos || 33u + rec[32] > len)
+			{
+				return false;
+			}
+
+			pos += len;
+
+			const u8 flags = rec[25];
+			const u32 name_len = rec[32];
+			const char* const name_ptr = reinterpret_cast<const char*>(rec + 33);
+
+			if (name_len == 1 && (name_ptr[0] == 0 || name_ptr[0] == 1))
+			{
+				// "." and ".." records
+				continue;
+			}
+
+			const extent data_ext{iso_read32(rec + 2) * s_sector_size, iso_read32(rec + 10)};
+
+			if (data_ext.offset > m_image->size || m_image->size - data_ext.offset < data_ext.size)
+			{
+				return false;
+			}
+
+			if (continued != -1)
+			{
+				// Next part of the file larger than 4 GiB
+				m_entries[continued].extents.push_back(data_ext);
+				m_entries[continued].size += data_ext.size;
+
+				if (!(flags & 0x80))
+				{
+					continued = -1;
+				}
+
+				continue;
+			}
+
+			entry e{};
+			e.name.assign(name_ptr, name_len);
+			e.is_dir = (flags & 0x2) != 0;
+			e.size = data_ext.size;
+			e.mtime = iso_read_time(rec + 18);
+			e.extents.push_back(data_ext);
+
+			if (!e.is_dir)
+			{
+				// Remove file version and the trailing dot
+				e.name.erase(std::min(e.name.find(';'), e.name.size()));
+
+				if (!e.name.empty() && e.name.back() == '.')
+				{
+					e.name.pop_back();
+				}
+			}
+
+			const u32 index = ::size32(m_entries);
+			const std::string key = (path.empty() ? "" : path + '/') + fmt::to_lower(e.name);
+
+			if (!m_index.emplace(key, index).second)
+			{
+				LOG_WARNING(LOADER, "ISO: duplicate entry '%s' ignored", key);
+				continue;
+			}
+
+			if (e.is_dir)
+			{
+				subdirs.push_back(index);
+			}
+			else if (flags & 0x80)
+			{
+				continued = index;
+			}
+
+			m_entries[dir].children.push_back(index);
+			m_entries.emplace_back(std::move(e));
+		}
+	}
+
+	for (u32 index : subdirs)
+	{
+		const std::string key = (path.empty() ? "" : path + '/') + fmt::to_lower(m_entries[index].name);
+
+		if (!read_dir(index, key, depth + 1))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const iso_device::entry* iso_device::find(const std::string& path) const
+{
+	std::string key;
+
+	// Normalize the path relative to the root, discarding empty, "." and ".." components
+	for (std::size_t pos = m_root.size(); pos < path.size();)
+	{
+		const std::size_t end = std::min(path.find_first_of('/', pos), path.size());
+		const std::string name = path.substr(pos, end - pos);
+		pos = end + 1;
+
+		if (name.empty() || name == ".")
+		{
+			continue;
+		}
+
+		if (name == "..")
+		{
+			key.erase(std::min(key.find_last_of('/'), key.size()));
+			continue;
+		}
+
+		if (!key.empty())
+		{
+			key += '/';
+		}
+
+		key += fmt::to_lower(name);
+	}
+
+	const auto found = m_index.find(key);
+
+	if (found == m_index.end())
+	{
+		fs::g_tls_error = fs::error::noent;
+		return nullptr;
+	}
+
+	return &m_entries[found->second];
+}
+
+bool iso_device::stat(const std::string& path, fs::stat_t& info)
+{
+	if (const auto e = find(path))
+	{
+		info.is_directory = e->is_dir;
+		info.is_writable = false;
+		info.size = e->size;
+		info.atime = e->mtime;
+		info.mtime = e->mtime;
+		info.ctime = e->mtime;
+		return true;
+	}
+
+	return false;
+}
+
+bool iso_device::statfs(const std::string& path, fs::device_stat& info)
+{
+	if (!find(path))
+	{
+		return false;
+	}
+
+	info.block_size = s_sector_size;
+	info.total_size = m_image->size;
+	info.total_free = 0;
+	info.avail_free = 0;
+	return true;
+}
+
+bool iso_device::remove_dir(const std::string& path)
+{
+	fs::g_tls_error = fs::error::acces;
+	return false;
+}
+
+bool iso_device::create_dir(const std::string& path)
+{
+	fs::g_tls_error = fs::error::acces;
+	return false;
+}
+
+bool iso_device::rename(const std::string& from, const std::string& to)
+{
+	fs::g_tls_error = fs::error::acces;
+	return false;
+}
+
+bool iso_device::remove(const std::string& path)
+{
+	fs::g_tls_error = fs::error::acces;
+	return false;
+}
+
+bool iso_device::trunc(const std::string& path, u64 length)
+{
+	fs::g_tls_error = fs::error::acces;
+	return false;
+}
+
+bool iso_device::utime(const std::string& path, s64 atime, s64 mtime)
+{
+	fs::g_tls_error = fs::error::acces;
+	return false;
+}
+
+std::unique_ptr<fs::file_base> iso_device::open(const std::string& path, bs_t<fs::open_mode> mode)
+{
+	if (test(mode & (fs::write + fs::append + fs::create + fs::trunc)))
+	{
+		fs::g_tls_error = fs::error::acces;
+		return nullptr;
+	}
+
+	const auto e = find(path);
+
+	if (!e)
+	{
+		return nullptr;
+	}
+
+	if (e->is_dir)
+	{
+		fs::g_tls_error = fs::error::acces;
+		return nullptr;
+	}
+
+	return std::make_unique<iso_file>(m_image, *e);
+}
+
+std::unique_ptr<fs::dir_base> iso_device::open_dir(const std::string& path)
+{
+	const auto e = find(path);
+
+	if (!e)
+	{
+		return nullptr;
+	}
+
+	if (!e->is_dir)
+	{
+		fs::g_tls_error = fs::error::inval;
+		return nullptr;
+	}
+
+	std::vector<fs::dir_entry> entries;
+	entries.reserve(e->children.size() + 2);
+
+	fs::dir_entry info{};
+	info.is_directory = true;
+	info.is_writable = false;
+	info.atime = info.mtime = info.ctime = e->mtime;
+
+	info.name = ".";
+	entries.emplace_back(info);
+	info.name = "..";
+	entries.emplace_back(info);
+
+	for (u32 index : e->children)
+	{
+		const entry& child = m_entries[index];
+		info.name = child.name;
+		info.is_directory = child.is_dir;
+		info.size = child.size;
+		info.atime = info.mtime = info.ctime = child.mtime;
+		entries.emplace_back(info);
+	}
+
+	return std::make_unique<iso_dir>(std::move(entries));
+}
+
+bool iso_is_image(const std::string& path)
+{
+	if (!fs::is_file(path))
+	{
+		return false;
+	}
+
+	fs::file file(path);
+
+	if (!file || file.size() < 17 * s_sector_size)
+	{
+		return false;
+	}
+
+	char magic[6];
+	file.seek(16 * s_sector_size);
+	return file.read(magic) && std::memcmp(magic + 1, "CD001", 5) == 0;
+}
+
+bool iso_mount(const std::string& root, const std::string& path)
+{
+	const auto device = std::make_shared<iso_device>(root, path);
+
+	if (!*device)
+	{
+		return false;
+	}
+
+	fs::set_virtual_device(root, device);
+	LOG_SUCCESS(LOADER, "ISO: mounted '%s' as %s", path, root);
+	return true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "../../Utilities/types.h"
+#include "../../Utilities/File.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Read-only memory mapping of the disc image file
+struct iso_image;
+
+// Read-only virtual device exposing ISO 9660 disc image contents (PS3 discs are UDF bridge discs, only the ISO 9660 tree is used)
+class iso_device final : public fs::device_base
+{
+public:
+	struct extent
+	{
+		u64 offset;
+		u64 size;
+	};
+
+	struct entry
+	{
+		std::string name;
+		bool is_dir;
+		u64 size;
+		s64 mtime;
+		std::vector<extent> extents; // File data (more than one for files larger than 4 GiB)
+		std::vector<u32> children; // Directory contents (indices in m_entries)
+	};
+
+private:
+	const std::string m_root;
+	const std::string m_path;
+
+	std::shared_ptr<iso_image> m_image;
+
+	// Directory index built once at mount, [0] is the root directory
+	std::vector<entry> m_entries;
+
+	// Lower-case path (relative to the root) -> index in m_entries
+	std::unordered_map<std::string, u32> m_index;
+
+	bool read_dir(u32 dir, const std::string& path, u32 depth);
+
+	const entry* find(const std::string& path) const;
+
+public:
+	iso_device(const std::string& root, const std::string& path);
+
+	// Check whether the image was successfully opened and indexed
+	explicit operator bool() const
+	{
+		return !m_entries.empty();
+	}
+
+	// Get the image file path
+	const std::string& get_image_path() const
+	{
+		return m_path;
+	}
+
+	bool stat(const std::string& path, fs::stat_t& info) override;
+	bool statfs(const std::string& path, fs::device_stat& info) override;
+	bool remove_dir(const std::string& path) override;
+	bool create_dir(const std::string& path) override;
+	bool rename(const std::string& from, const std::string& to) override;
+	bool remove(const std::string& path) override;
+	bool trunc(const std::string& path, u64 length) override;
+	bool utime(const std::string& path, s64 atime, s64 mtime) override;
+
+	std::unique_ptr<fs::file_base> open(const std::string& path, bs_t<fs::open_mode> mode) override;
+	std::unique_ptr<fs::dir_base> open_dir(const std::string& path) override;
+};
+
+// Check whether the file has an ISO 9660 volume descriptor
+bool iso_is_image(const std::string& path);
+
+// Mount the disc image as a virtual device (root must be like "//iso")
+bool iso_mount(const std::string& root, const std::string& path);
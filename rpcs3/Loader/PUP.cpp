@@ -1,6 +1,9 @@
 #include "stdafx.h"
 
 #include "PUP.h"
+#include "TAR.h"
+#include "Crypto/unself.h"
+#include "Utilities/Thread.h"
 
 pup_object::pup_object(const fs::file& file): m_file(file)
 {
@@ -34,3 +37,113 @@ fs::file pup_object::get_file(u64 entry_id)
 	}
 	return fs::file();
 };
+
+bool pup_install(const std::string& path, const std::string& dev_flash, atomic_t<double>& progress, std::string* error)
+{
+	atomic_t<bool> failed{false};
+
+	// Report the first error
+	auto fail = [&](std::string&& msg)
+	{
+		LOG_ERROR(LOADER, "PUP: %s", msg);
+
+		if (!failed.exchange(true) && error)
+		{
+			*error = std::move(msg);
+		}
+	};
+
+	fs::file pup_f(path);
+
+	if (!pup_f)
+	{
+		fail(fmt::format("Failed to open %s (%s)", path, fs::g_tls_error));
+		return false;
+	}
+
+	pup_object pup(pup_f);
+
+	if (!pup)
+	{
+		fail(fmt::format("PUP file is invalid: %s", path));
+		return false;
+	}
+
+	const fs::file update_files_f = pup.get_file(0x300);
+	tar_object update_files(update_files_f);
+
+	// Read all dev_flash packages before going parallel (tar_object isn't thread-safe)
+	std::vector<fs::file> packages;
+
+	for (const std::string& name : update_files.get_filenames())
+	{
+		if (name.find("dev_flash_") != -1)
+		{
+			packages.emplace_back(update_files.get_file(name));
+		}
+	}
+
+	pup_f.close();
+
+	if (packages.empty())
+	{
+		fail(fmt::format("No dev_flash packages found in %s", path));
+		return false;
+	}
+
+	const u32 total = ::size32(packages);
+	atomic_t<u32> done{0};
+
+	thread_ctrl::parallel_for("Firmware Installer", total, [&](u32 i)
+	{
+		if (failed || progress < 0)
+		{
+			return false;
+		}
+
+		SCEDecrypter self_dec(packages[i]);
+		self_dec.LoadHeaders();
+		self_dec.LoadMetadata(SCEPKG_ERK, SCEPKG_RIV);
+		self_dec.DecryptData();
+
+		auto dev_flash_tar_f = self_dec.MakeFile();
+
+		// Release the encrypted package
+		packages[i].close();
+
+		if (dev_flash_tar_f.size() < 3)
+		{
+			fail(fmt::format("Failed to decrypt dev_flash package %u", i));
+			return false;
+		}
+
+		tar_object dev_flash_tar(dev_flash_tar_f[2]);
+
+		if (!dev_flash_tar.extract(dev_flash, "dev_flash/"))
+		{
+			fail(fmt::format("Failed to extract dev_flash package %u to %s (invalid TAR contents or write error)", i, dev_flash));
+			return false;
+		}
+
+		const double value = static_cast<double>(++done) / total;
+
+		// Don't overwrite cancellation
+		progress.fetch_op([&](double& v)
+		{
+			if (v >= 0)
+			{
+				v = value;
+			}
+		});
+
+		return true;
+	});
+
+	if (failed || progress < 0)
+	{
+		return false;
+	}
+
+	progress = 1.;
+	return true;
+}
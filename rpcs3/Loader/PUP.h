@@ -2,6 +2,7 @@
 
 #include "../../Utilities/types.h"
 #include "../../Utilities/File.h"
+#include "../../Utilities/Atomic.h"
 
 #include <vector>
 
@@ -45,3 +46,8 @@ public:
 
 	fs::file get_file(u64 entry_id);
 };
+
+// Install firmware from the update package to dev_flash, decrypting and extracting its packages in parallel.
+// Progress is updated from 0 to 1, setting it to a negative value from another thread cancels the installation.
+// On failure, the error description is written to *error (left empty if cancelled).
+bool pup_install(const std::string& path, const std::string& dev_flash, atomic_t<double>& progress, std::string* error = nullptr);
@@ -113,6 +113,19 @@ bool tar_object::extract(std::string path, std::string ignore)
 		case '0':
 		{
 			fs::file file(result, fs::rewrite);
+
+			// Parent directory may belong to another archive (extracted in parallel)
+			if (!file && fs::create_path(fs::get_parent_dir(result)))
+			{
+				file.open(result, fs::rewrite);
+			}
+
+			if (!file)
+			{
+				LOG_ERROR(GENERAL, "TAR Loader: failed to create file %s (%s)", result, fs::g_tls_error);
+				return false;
+			}
+
 			file.write(get_file(header.name).to_vector<u8>());
 			break;
 		}
@@ -9,6 +9,7 @@
 
 #include "rpcs3_app.h"
 #include "Utilities/sema.h"
+#include "Emu/System.h"
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -96,15 +97,35 @@ int main(int argc, char** argv)
 	QCoreApplication::setAttribute(Qt::AA_DontCheckOpenGLContextThreadAffinity);
 
 	s_init.post();
-	s_qt_mutex.wait();
-	rpcs3_app app(argc, argv);
 
 	// Command line args
 	QCommandLineParser parser;
 	parser.setApplicationDescription("Welcome to RPCS3 command line.");
 	parser.addPositionalArgument("(S)ELF", "Path for directly executing a (S)ELF");
 	parser.addPositionalArgument("[Args...]", "Optional args for the executable");
+	const QCommandLineOption installfw_option("installfw", "Install firmware from PS3UPDAT.PUP and exit", "path");
+	parser.addOption(installfw_option);
 	parser.addHelpOption();
+
+	// Install firmware without GUI: rpcs3 --installfw <PS3UPDAT.PUP> (parsed before the application is created)
+	{
+		QStringList arguments;
+
+		for (int i = 0; i < argc; i++)
+		{
+			arguments << QString::fromLocal8Bit(argv[i]);
+		}
+
+		if (parser.parse(arguments) && parser.isSet(installfw_option))
+		{
+			Emu.Init();
+			return Emu.InstallPup(sstr(parser.value(installfw_option))) ? 0 : 1;
+		}
+	}
+
+	s_qt_mutex.wait();
+	rpcs3_app app(argc, argv);
+
 	parser.parse(QCoreApplication::arguments());
 
 	app.Init();
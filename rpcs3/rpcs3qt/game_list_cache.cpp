@@ -0,0 +1,324 @@
+#include "game_list_cache.h"
+
+#include "Loader/PSF.h"
+#include "Utilities/Thread.h"
+
+#include <typeinfo>
+#include <unordered_set>
+
+constexpr u32 s_cache_magic = "GLC\0"_u32;
+constexpr u32 s_cache_version = 1;
+
+static void write_string(std::vector<u8>& out, const std::string& str)
+{
+	const u32 size = ::size32(str);
+	out.insert(out.end(), reinterpret_cast<const u8*>(&size), reinterpret_cast<const u8*>(&size + 1));
+	out.insert(out.end(), str.begin(), str.end());
+}
+
+template <typename T>
+static void write_pod(std::vector<u8>& out, const T& value)
+{
+	out.insert(out.end(), reinterpret_cast<const u8*>(&value), reinterpret_cast<const u8*>(&value + 1));
+}
+
+template <typename T>
+static bool read_pod(const fs::file& file, T& value)
+{
+	return file.read(value);
+}
+
+static bool read_string(const fs::file& file, std::string& str)
+{
+	u32 size;
+	return file.read(size) && size <= file.size() && file.read(str, size);
+}
+
+game_list_cache::game_list_cache(const std::string& path)
+	: m_path(path)
+{
+	const fs::file file(path);
+
+	u32 magic, version, count;
+
+	if (!file || !file.read(magic) || !file.read(version) || !file.read(count) || magic != s_cache_magic || version != s_cache_version)
+	{
+		return;
+	}
+
+	for (u32 i = 0; i < count; i++)
+	{
+		std::string dir;
+		record r{};
+		GameInfo& info = r.data.info;
+
+		s32 width, height;
+
+		if (!read_string(file, dir) ||
+			!read_string(file, info.path) ||
+			!read_string(file, info.icon_path) ||
+			!read_string(file, info.name) ||
+			!read_string(file, info.serial) ||
+			!read_string(file, info.app_ver) ||
+			!read_string(file, info.category) ||
+			!read_string(file, info.fw) ||
+			!read_pod(file, info.attr) ||
+			!read_pod(file, info.bootable) ||
+			!read_pod(file, info.parental_lvl) ||
+			!read_pod(file, info.sound_format) ||
+			!read_pod(file, info.resolution) ||
+			!read_pod(file, r.sfo_mtime) ||
+			!read_pod(file, r.sfo_size) ||
+			!read_pod(file, r.icon_mtime) ||
+			!read_pod(file, r.icon_size) ||
+			!read_pod(file, width) ||
+			!read_pod(file, height))
+		{
+			LOG_ERROR(GENERAL, "Game list cache is corrupted: %s", path);
+			m_records.clear();
+			return;
+		}
+
+		r.scaled_to = QSize(width, height);
+
+		if (!read_pod(file, width) || !read_pod(file, height) || width < 0 || height < 0 || u64{4} * width * height > file.size())
+		{
+			LOG_ERROR(GENERAL, "Game list cache is corrupted: %s", path);
+			m_records.clear();
+			return;
+		}
+
+		if (width && height)
+		{
+			r.data.icon = QImage(width, height, QImage::Format_ARGB32);
+
+			for (s32 y = 0; y < height; y++)
+			{
+				if (file.read(r.data.icon.scanLine(y), width * 4) != width * 4u)
+				{
+					LOG_ERROR(GENERAL, "Game list cache is corrupted: %s", path);
+					m_records.clear();
+					return;
+				}
+			}
+		}
+
+		m_records.emplace(std::move(dir), std::move(r));
+	}
+}
+
+bool game_list_cache::get(const std::string& dir, const QSize& icon_size, entry& out)
+{
+	const std::string sfb = dir + "/PS3_DISC.SFB";
+	const std::string sfo = dir + (fs::is_file(sfb) ? "/PS3_GAME/PARAM.SFO" : "/PARAM.SFO");
+
+	fs::stat_t sfo_stat;
+
+	if (!fs::stat(sfo, sfo_stat) || sfo_stat.is_directory)
+	{
+		return false;
+	}
+
+	record cached;
+	bool is_cached = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		const auto found = m_records.find(dir);
+
+		if (found != m_records.end())
+		{
+			cached = found->second;
+			is_cached = true;
+		}
+	}
+
+	if (is_cached && cached.sfo_mtime == sfo_stat.mtime && cached.sfo_size == sfo_stat.size && cached.scaled_to == icon_size)
+	{
+		fs::stat_t icon_stat{};
+		const bool has_icon = fs::stat(cached.data.info.icon_path, icon_stat);
+
+		if (cached.icon_mtime == (has_icon ? icon_stat.mtime : 0) && cached.icon_size == (has_icon ? icon_stat.size : 0))
+		{
+			out = std::move(cached.data);
+			return true;
+		}
+	}
+
+	const fs::file sfo_file(sfo);
+
+	if (!sfo_file)
+	{
+		return false;
+	}
+
+	const auto psf = psf::load_object(sfo_file);
+
+	record r{};
+	GameInfo& game = r.data.info;
+	game.path         = dir;
+	game.serial       = psf::get_string(psf, "TITLE_ID", "");
+	game.name         = psf::get_string(psf, "TITLE", "");
+	game.app_ver      = psf::get_string(psf, "APP_VER", "");
+	game.category     = psf::get_string(psf, "CATEGORY", "");
+	game.fw           = psf::get_string(psf, "PS3_SYSTEM_VER", "");
+	game.parental_lvl = psf::get_integer(psf, "PARENTAL_LEVEL");
+	game.resolution   = psf::get_integer(psf, "RESOLUTION");
+	game.sound_format = psf::get_integer(psf, "SOUND_FORMAT");
+	game.bootable     = psf::get_integer(psf, "BOOTABLE", 0);
+	game.attr         = psf::get_integer(psf, "ATTRIBUTE", 0);
+	game.icon_path    = dir + (game.category == "DG" ? "/PS3_GAME/ICON0.PNG" : "/ICON0.PNG");
+
+	r.sfo_mtime = sfo_stat.mtime;
+	r.sfo_size = sfo_stat.size;
+	r.scaled_to = icon_size;
+
+	fs::stat_t icon_stat;
+
+	if (fs::stat(game.icon_path, icon_stat))
+	{
+		r.icon_mtime = icon_stat.mtime;
+		r.icon_size = icon_stat.size;
+	}
+
+	QImage img;
+
+	if (img.load(QString::fromStdString(game.icon_path)))
+	{
+		r.data.icon = img.scaled(icon_size, Qt::KeepAspectRatio, Qt::TransformationMode::SmoothTransformation).convertToFormat(QImage::Format_ARGB32);
+	}
+	else
+	{
+		LOG_WARNING(GENERAL, "Could not load image from path %s", game.icon_path);
+	}
+
+	out = r.data;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_records[dir] = std::move(r);
+	m_dirty = true;
+	return true;
+}
+
+bool game_list_cache::scan(const std::vector<std::string>& dirs, const QSize& icon_size, std::vector<entry>& out, const std::function<bool()>& cancel)
+{
+	const u32 total = ::size32(dirs);
+
+	std::vector<entry> entries(total);
+	std::vector<u8> found(total);
+
+	thread_ctrl::parallel_for("Game List Scanner", total, [&](u32 i)
+	{
+		if (cancel())
+		{
+			return false;
+		}
+
+		try
+		{
+			found[i] = get(dirs[i], icon_size, entries[i]);
+		}
+		catch (const std::exception& e)
+		{
+			LOG_FATAL(GENERAL, "Failed to update game list at %s\n%s thrown: %s", dirs[i], typeid(e).name(), e.what());
+		}
+
+		return true;
+	});
+
+	if (cancel())
+	{
+		return false;
+	}
+
+	for (u32 i = 0; i < total; i++)
+	{
+		if (found[i])
+		{
+			out.emplace_back(std::move(entries[i]));
+		}
+	}
+
+	// Forget games which are gone
+	const std::unordered_set<std::string> present(dirs.begin(), dirs.end());
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (auto it = m_records.begin(); it != m_records.end();)
+	{
+		if (present.count(it->first))
+		{
+			++it;
+			continue;
+		}
+
+		it = m_records.erase(it);
+		m_dirty = true;
+	}
+
+	return true;
+}
+
+void game_list_cache::save()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!m_dirty)
+	{
+		return;
+	}
+
+	std::vector<u8> out;
+	write_pod(out, s_cache_magic);
+	write_pod(out, s_cache_version);
+	write_pod(out, ::size32(m_records));
+
+	for (const auto& pair : m_records)
+	{
+		const record& r = pair.second;
+		const GameInfo& info = r.data.info;
+
+		write_string(out, pair.first);
+		write_string(out, info.path);
+		write_string(out, info.icon_path);
+		write_string(out, info.name);
+		write_string(out, info.serial);
+		write_string(out, info.app_ver);
+		write_string(out, info.category);
+		write_string(out, info.fw);
+		write_pod(out, info.attr);
+		write_pod(out, info.bootable);
+		write_pod(out, info.parental_lvl);
+		write_pod(out, info.sound_format);
+		write_pod(out, info.resolution);
+		write_pod(out, r.sfo_mtime);
+		write_pod(out, r.sfo_size);
+		write_pod(out, r.icon_mtime);
+		write_pod(out, r.icon_size);
+		write_pod(out, s32{r.scaled_to.width()});
+		write_pod(out, s32{r.scaled_to.height()});
+		write_pod(out, s32{r.data.icon.width()});
+		write_pod(out, s32{r.data.icon.height()});
+
+		for (s32 y = 0; y < r.data.icon.height(); y++)
+		{
+			const u8* line = r.data.icon.constScanLine(y);
+			out.insert(out.end(), line, line + r.data.icon.width() * 4);
+		}
+	}
+
+	// Write to the temporary file first, so it isn't left incomplete
+	if (fs::file file{m_path + ".tmp", fs::rewrite})
+	{
+		file.write(out);
+		file.close();
+
+		if (fs::rename(m_path + ".tmp", m_path, true))
+		{
+			m_dirty = false;
+			return;
+		}
+	}
+
+	LOG_ERROR(GENERAL, "Failed to save game list cache: %s (%s)", m_path, fs::g_tls_error);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "stdafx.h"
+#include "Emu/GameInfo.h"
+
+#include <QImage>
+#include <QSize>
+
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+
+// Persistent game list data: parsed PARAM.SFO fields and pre-scaled icons, keyed by game directory
+class game_list_cache
+{
+public:
+	struct entry
+	{
+		GameInfo info; // Raw PARAM.SFO values (missing strings are empty)
+		QImage icon; // Scaled to the icon size (null if not available)
+	};
+
+private:
+	struct record
+	{
+		entry data;
+
+		// Validation data
+		s64 sfo_mtime;
+		u64 sfo_size;
+		s64 icon_mtime;
+		u64 icon_size;
+		QSize scaled_to;
+	};
+
+	const std::string m_path;
+
+	std::mutex m_mutex;
+	std::unordered_map<std::string, record> m_records;
+	bool m_dirty = false;
+
+	// Load or reuse single entry
+	bool get(const std::string& dir, const QSize& icon_size, entry& out);
+
+public:
+	explicit game_list_cache(const std::string& path);
+
+	// Scan game directories in parallel, only reading changed entries (returns false if aborted by cancel())
+	bool scan(const std::vector<std::string>& dirs, const QSize& icon_size, std::vector<entry>& out, const std::function<bool()>& cancel);
+
+	// Write the cache file if anything changed
+	void save();
+};
@@ -8,6 +8,7 @@
 #include "Emu/System.h"
 #include "Loader/PSF.h"
 #include "Utilities/types.h"
+#include "Utilities/Thread.h"
 
 #include <algorithm>
 #include <iterator>
@@ -204,6 +205,14 @@ void game_list_frame::LoadSettings()
 
 game_list_frame::~game_list_frame()
 {
+	// Cancel the background scan
+	++m_refresh_id;
+
+	if (m_refresh_thread)
+	{
+		m_refresh_thread->join();
+	}
+
 	SaveSettings();
 }
 
@@ -356,11 +365,6 @@ void game_list_frame::Refresh(const bool fromDrive, const bool scrollAfter)
 {
 	if (fromDrive)
 	{
-		// Load PSF
-
-		m_game_data.clear();
-		m_notes.clear();
-
 		const std::string _hdd = Emu.GetHddDir();
 
 		std::vector<std::string> path_list;
@@ -385,108 +389,41 @@ void game_list_frame::Refresh(const bool fromDrive, const bool scrollAfter)
 			path_list.back().resize(path_list.back().find_last_not_of('/') + 1);
 		}
 
-		// Used to remove duplications from the list (serial -> set of cats)
-		std::map<std::string, std::set<std::string>> serial_cat;
+		// Cancel the previous scan
+		const u64 id = ++m_refresh_id;
 
-		QSet<QString> serials;
+		if (m_refresh_thread)
+		{
+			m_refresh_thread->join();
+		}
 
-		for (const auto& dir : path_list) { try
+		if (!m_game_cache)
 		{
-			const std::string sfb = dir + "/PS3_DISC.SFB";
-			const std::string sfo = dir + (fs::is_file(sfb) ? "/PS3_GAME/PARAM.SFO" : "/PARAM.SFO");
+			m_game_cache = std::make_shared<game_list_cache>(sstr(m_gui_settings->GetSettingsDir()) + "/game_list_cache.dat");
+		}
 
-			const fs::file sfo_file(sfo);
-			if (!sfo_file)
-			{
-				continue;
-			}
+		// Load PSF and icons in background, the current list is shown until finished
+		thread_ctrl::spawn(m_refresh_thread, "Game List Refresh", [this, id, path_list = std::move(path_list), icon_size = m_Icon_Size, cache = m_game_cache, scrollAfter]()
+		{
+			std::vector<game_list_cache::entry> entries;
 
-			const auto psf = psf::load_object(sfo_file);
-
-			GameInfo game;
-			game.path         = dir;
-			game.serial       = psf::get_string(psf, "TITLE_ID", "");
-			game.name         = psf::get_string(psf, "TITLE", sstr(category::unknown));
-			game.app_ver      = psf::get_string(psf, "APP_VER", sstr(category::unknown));
-			game.category     = psf::get_string(psf, "CATEGORY", sstr(category::unknown));
-			game.fw           = psf::get_string(psf, "PS3_SYSTEM_VER", sstr(category::unknown));
-			game.parental_lvl = psf::get_integer(psf, "PARENTAL_LEVEL");
-			game.resolution   = psf::get_integer(psf, "RESOLUTION");
-			game.sound_format = psf::get_integer(psf, "SOUND_FORMAT");
-			game.bootable     = psf::get_integer(psf, "BOOTABLE", 0);
-			game.attr         = psf::get_integer(psf, "ATTRIBUTE", 0);
-
-			// Detect duplication
-			if (!serial_cat[game.serial].emplace(game.category).second)
+			if (!cache->scan(path_list, icon_size, entries, [&] { return m_refresh_id != id; }))
 			{
-				continue;
+				return;
 			}
 
-			QString serial = qstr(game.serial);
-			m_notes[serial] = m_gui_settings->GetValue(gui::notes, serial, "").toString();
-			serials.insert(serial);
+			cache->save();
 
-			auto cat = category::cat_boot.find(game.category);
-			if (cat != category::cat_boot.end())
+			QMetaObject::invokeMethod(this, [this, id, entries = std::move(entries), scrollAfter]() mutable
 			{
-				if (game.category == "DG")
+				if (m_refresh_id == id)
 				{
-					game.icon_path = dir + "/PS3_GAME/ICON0.PNG";
+					OnRefreshFinished(std::move(entries), scrollAfter);
 				}
-				else
-				{
-					game.icon_path = dir + "/ICON0.PNG";
-				}
-
-				game.category = sstr(cat->second);
-			}
-			else if ((cat = category::cat_data.find(game.category)) != category::cat_data.end())
-			{
-				game.icon_path = dir + "/ICON0.PNG";
-				game.category = sstr(cat->second);
-			}
-			else if (game.category == sstr(category::unknown))
-			{
-				game.icon_path = dir + "/ICON0.PNG";
-			}
-			else
-			{
-				game.icon_path = dir + "/ICON0.PNG";
-				game.category = sstr(category::other);
-			}
-
-			// Load Image
-			QImage img;
-
-			if (game.icon_path.empty() || !img.load(qstr(game.icon_path)))
-			{
-				LOG_WARNING(GENERAL, "Could not load image from path %s", sstr(QDir(qstr(game.icon_path)).absolutePath()));
-			}
-
-			bool hasCustomConfig = fs::is_file(fs::get_config_dir() + "data/" + game.serial + "/config.yml");
-
-			QPixmap pxmap = PaintedPixmap(img, hasCustomConfig);
-
-			m_game_data.push_back(game_info(new gui_game_info{ game, m_game_compat->GetCompatibility(game.serial), img, pxmap, hasCustomConfig }));
-		}
-		catch (const std::exception& e)
-		{
-			LOG_FATAL(GENERAL, "Failed to update game list at %s\n%s thrown: %s", dir, typeid(e).name(), e.what());
-			continue;
-			// Blame MSVC for double }}
-		}}
-
-		auto op = [](const game_info& game1, const game_info& game2)
-		{
-			return qstr(game1->info.name).toLower() < qstr(game2->info.name).toLower();
-		};
-
-		// Sort by name at the very least.
-		std::sort(m_game_data.begin(), m_game_data.end(), op);
+			}, Qt::QueuedConnection);
+		});
 
-		// clean up hidden games list
-		m_hidden_list.intersect(serials);
-		m_gui_settings->SetValue(gui::gl_hidden_list, QStringList(m_hidden_list.toList()));
+		return;
 	}
 
 	// Fill Game List / Game Grid
@@ -909,6 +846,74 @@ bool game_list_frame::DeleteSPUCache(const std::string& base_dir, bool is_intera
 	return true;
 }
 
+void game_list_frame::OnRefreshFinished(std::vector<game_list_cache::entry>&& entries, bool scrollAfter)
+{
+	m_game_data.clear();
+	m_notes.clear();
+
+	// Used to remove duplications from the list (serial -> set of cats)
+	std::map<std::string, std::set<std::string>> serial_cat;
+
+	QSet<QString> serials;
+
+	for (auto& entry : entries)
+	{
+		GameInfo& game = entry.info;
+
+		for (std::string* str : {&game.name, &game.app_ver, &game.category, &game.fw})
+		{
+			if (str->empty())
+			{
+				*str = sstr(category::unknown);
+			}
+		}
+
+		// Detect duplication
+		if (!serial_cat[game.serial].emplace(game.category).second)
+		{
+			continue;
+		}
+
+		QString serial = qstr(game.serial);
+		m_notes[serial] = m_gui_settings->GetValue(gui::notes, serial, "").toString();
+		serials.insert(serial);
+
+		auto cat = category::cat_boot.find(game.category);
+		if (cat != category::cat_boot.end())
+		{
+			game.category = sstr(cat->second);
+		}
+		else if ((cat = category::cat_data.find(game.category)) != category::cat_data.end())
+		{
+			game.category = sstr(cat->second);
+		}
+		else if (game.category != sstr(category::unknown))
+		{
+			game.category = sstr(category::other);
+		}
+
+		bool hasCustomConfig = fs::is_file(fs::get_config_dir() + "data/" + game.serial + "/config.yml");
+
+		QPixmap pxmap = PaintedPixmap(entry.icon, hasCustomConfig);
+
+		m_game_data.push_back(game_info(new gui_game_info{ game, m_game_compat->GetCompatibility(game.serial), entry.icon, pxmap, hasCustomConfig }));
+	}
+
+	auto op = [](const game_info& game1, const game_info& game2)
+	{
+		return qstr(game1->info.name).toLower() < qstr(game2->info.name).toLower();
+	};
+
+	// Sort by name at the very least.
+	std::sort(m_game_data.begin(), m_game_data.end(), op);
+
+	// clean up hidden games list
+	m_hidden_list.intersect(serials);
+	m_gui_settings->SetValue(gui::gl_hidden_list, QStringList(m_hidden_list.toList()));
+
+	Refresh(false, scrollAfter);
+}
+
 QPixmap game_list_frame::PaintedPixmap(const QImage& img, bool paint_config_icon)
 {
 	const QSize original_size = img.size();
@@ -986,6 +991,12 @@ void game_list_frame::RepaintIcons(const bool& fromSettings)
 
 	for (auto& game : m_game_data)
 	{
+		// Icons from the game list cache are pre-scaled, reload the original for a bigger size
+		if (!game->icon.isNull() && game->icon.width() < m_Icon_Size.width() && game->icon.height() < m_Icon_Size.height())
+		{
+			game->icon.load(qstr(game->info.icon_path));
+		}
+
 		game->pxmap = PaintedPixmap(game->icon, game->hasCustomConfig);
 	}
 
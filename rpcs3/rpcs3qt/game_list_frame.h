@@ -8,6 +8,7 @@
 #include "game_list_grid.h"
 #include "emu_settings.h"
 #include "game_compatibility.h"
+#include "game_list_cache.h"
 
 #include <QMainWindow>
 #include <QToolBar>
@@ -17,6 +18,8 @@
 
 #include <memory>
 
+class thread_ctrl;
+
 enum Category
 {
 	Disc_Game,
@@ -229,6 +232,7 @@ protected:
 	bool eventFilter(QObject *object, QEvent *event) override;
 private:
 	QPixmap PaintedPixmap(const QImage& img, bool paint_config_icon = false);
+	void OnRefreshFinished(std::vector<game_list_cache::entry>&& entries, bool scrollAfter);
 	void ShowCustomConfigIcon(QTableWidgetItem* item, bool enabled);
 	void PopulateGameGrid(int maxCols, const QSize& image_size, const QColor& image_color);
 	bool IsEntryVisible(const game_info& game);
@@ -271,6 +275,11 @@ private:
 	QSet<QString> m_hidden_list;
 	bool m_show_hidden{false};
 
+	// Background scanning (the latest refresh id invalidates older scans)
+	std::shared_ptr<game_list_cache> m_game_cache;
+	std::shared_ptr<thread_ctrl> m_refresh_thread;
+	atomic_t<u64> m_refresh_id{0};
+
 	// Search
 	QString m_search_text;
 
@@ -307,5 +307,18 @@ void kernel_explorer::Update()
 
 	// RawSPU Threads (TODO)
 
+	// Contention statistics (sorted by total wait time)
+	const auto sync_profile = lv2_sync_stats::report();
+
+	if (!sync_profile.empty())
+	{
+		QTreeWidgetItem* node = l_addTreeChild(root, qstr(fmt::format("Sync Profile (%zu)", sync_profile.size())));
+
+		for (const auto& line : sync_profile)
+		{
+			l_addTreeChild(node, qstr(line));
+		}
+	}
+
 	root->setExpanded(true);
 }
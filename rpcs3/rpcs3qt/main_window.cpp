@@ -562,6 +562,9 @@ void main_window::InstallPup(const QString& dropPath)
 		return;
 	}
 
+	update_files_f.close();
+	pup_f.close();
+
 	progress_dialog pdlg(tr("Installing firmware version %1\nPlease wait...").arg(qstr(version_string)), tr("Cancel"), 0, static_cast<int>(updatefilenames.size()), this);
 	pdlg.setWindowTitle(tr("RPCS3 Firmware Installer"));
 	pdlg.setWindowModality(Qt::WindowModal);
@@ -569,67 +572,46 @@ void main_window::InstallPup(const QString& dropPath)
 	pdlg.show();
 
 	// Synchronization variable
-	atomic_t<int> progress(0);
+	atomic_t<double> progress(0.);
+	bool result = false;
+	std::string error;
 	{
-		// Run asynchronously
+		// Run asynchronously (packages are decrypted and extracted in parallel)
 		scope_thread worker("Firmware Installer", [&]
 		{
-			for (const auto& updatefilename : updatefilenames)
-			{
-				if (progress == -1) break;
-
-				fs::file updatefile = update_files.get_file(updatefilename);
-
-				SCEDecrypter self_dec(updatefile);
-				self_dec.LoadHeaders();
-				self_dec.LoadMetadata(SCEPKG_ERK, SCEPKG_RIV);
-				self_dec.DecryptData();
-
-				auto dev_flash_tar_f = self_dec.MakeFile();
-				if (dev_flash_tar_f.size() < 3)
-				{
-					LOG_ERROR(GENERAL, "Error while installing firmware: PUP contents are invalid.");
-					QMessageBox::critical(this, tr("Failure!"), tr("Error while installing firmware: PUP contents are invalid."));
-					progress = -1;
-				}
-
-				tar_object dev_flash_tar(dev_flash_tar_f[2]);
-				if (!dev_flash_tar.extract(g_cfg.vfs.get_dev_flash(), "dev_flash/"))
-				{
-					LOG_ERROR(GENERAL, "Error while installing firmware: TAR contents are invalid.");
-					QMessageBox::critical(this, tr("Failure!"), tr("Error while installing firmware: TAR contents are invalid."));
-					progress = -1;
-				}
+			result = pup_install(path, g_cfg.vfs.get_dev_flash(), progress, &error);
 
-				if (progress >= 0)
-					progress += 1;
+			if (!result)
+			{
+				progress = -1.;
 			}
 		});
 
 		// Wait for the completion
-		while (std::this_thread::sleep_for(5ms), std::abs(progress) < pdlg.maximum())
+		while (std::this_thread::sleep_for(5ms), std::abs(progress) < 1.)
 		{
 			if (pdlg.wasCanceled())
 			{
-				progress = -1;
+				progress = -1.;
 				break;
 			}
 			// Update progress window
-			pdlg.SetValue(static_cast<int>(progress));
+			pdlg.SetValue(static_cast<int>(progress * pdlg.maximum()));
 			QCoreApplication::processEvents();
 		}
+	}
 
-		update_files_f.close();
-		pup_f.close();
-
-		if (progress > 0)
-		{
-			pdlg.SetValue(pdlg.maximum());
-			std::this_thread::sleep_for(100ms);
-		}
+	if (result)
+	{
+		pdlg.SetValue(pdlg.maximum());
+		std::this_thread::sleep_for(100ms);
+	}
+	else if (!pdlg.wasCanceled())
+	{
+		QMessageBox::critical(this, tr("Failure!"), tr("Error while installing firmware: %1").arg(qstr(error)));
 	}
 
-	if (progress > 0)
+	if (result)
 	{
 		LOG_SUCCESS(GENERAL, "Successfully installed PS3 firmware version %s.", version_string);
 		guiSettings->ShowInfoBox(gui::ib_pup_success, tr("Success!"), tr("Successfully installed PS3 firmware and LLE Modules!"), this);